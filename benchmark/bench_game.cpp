@@ -0,0 +1,213 @@
+#include "benchmark.hpp"
+
+#include "depth_order.hpp"
+#include "game.hpp"
+#include "interactable_object.hpp"
+#include "script_cache.hpp"
+#include "skeleton_drawable.hpp"
+
+#include <map>
+#include <random>
+
+namespace {
+
+/// The game with its start scene loaded from the bundled data/ folder, created on first use so
+/// that the benchmarks which don't need a window don't open one
+struct GameFixture {
+	GameFixture() {
+		useDataFolder();
+		jngl::setVolume(0);
+		const YAML::Node config = YAML::Load(jngl::readAsset("config/game.json").str());
+		jngl::showWindow(config["name"].as<std::string>(), 800, 600, 0, { 16, 9 }, { 16, 9 });
+		jngl::writeConfig("savegame", ""); // always start from the beginning, like the unit tests
+
+		game = std::make_shared<Game>(config);
+		game->init();
+		game->enable_fade = false;
+		game->step();
+		game->step();
+		startScene = game->currentScene->getSceneName();
+		background = game->currentScene->background;
+		game->triangulateBorder();
+
+		for (const auto& obj : game->gameObjects) {
+			if (obj == game->pointer) {
+				continue;
+			}
+			objects.push_back(obj);
+			// The one with the most bones is usually the most expensive one to animate
+			if (obj->skeleton && (!biggestSkeleton || obj->skeleton->skeleton->getBones().size() >
+			                                              biggestSkeleton->skeleton->getBones().size())) {
+				biggestSkeleton = obj->skeleton.get();
+			}
+		}
+
+		std::mt19937 random(0);
+		const jngl::Vec2 screensize = jngl::getScreenSize();
+		const jngl::Vec2 camera = game->getCameraPosition();
+		std::uniform_real_distribution<double> x(camera.x - screensize.x / 2,
+		                                         camera.x + screensize.x / 2);
+		std::uniform_real_distribution<double> y(camera.y - screensize.y / 2,
+		                                         camera.y + screensize.y / 2);
+		std::vector<jngl::Vec2> walkable;
+		for (int i = 0; i < 10000 && walkable.size() < 65; ++i) {
+			const jngl::Vec2 point(x(random), y(random));
+			if (background && background->is_walkable(point)) {
+				walkable.push_back(point);
+			}
+		}
+		for (size_t i = 1; i < walkable.size(); ++i) {
+			paths.emplace_back(walkable[i - 1], walkable[i]);
+		}
+
+		std::uniform_real_distribution<double> offset(-300, 300);
+		for (int i = 0; i < 64; ++i) {
+			points.emplace_back(offset(random), offset(random));
+		}
+	}
+
+	std::shared_ptr<Game> game;
+	std::string startScene;
+	std::shared_ptr<Background> background;
+	std::vector<std::shared_ptr<SpineObject>> objects;
+	SkeletonDrawable* biggestSkeleton = nullptr;
+	/// Pairs of walkable points in the visible part of the start scene
+	std::vector<std::pair<jngl::Vec2, jngl::Vec2>> paths;
+	/// Relative to an object's position
+	std::vector<jngl::Vec2> points;
+	size_t next = 0;
+	jngl::FrameBuffer frameBuffer{ jngl::getWindowSize() };
+
+	const std::pair<jngl::Vec2, jngl::Vec2>* nextPath() {
+		return paths.empty() ? nullptr : &paths[next++ % paths.size()];
+	}
+};
+
+GameFixture& fixture() {
+	static GameFixture fixture;
+	return fixture;
+}
+
+const Benchmark getPathToTarget("Background::getPathToTarget start scene", [] {
+	auto& f = fixture();
+	if (const auto* path = f.nextPath()) {
+		doNotOptimize(f.background->getPathToTarget(path->first, path->second));
+	}
+});
+
+const Benchmark hasPathTo("Background::hasPathTo start scene", [] {
+	auto& f = fixture();
+	if (const auto* path = f.nextPath()) {
+		doNotOptimize(f.background->hasPathTo(path->first, path->second));
+	}
+});
+
+const Benchmark containsPoint("SpineObject::containsPoint all objects", [] {
+	auto& f = fixture();
+	const auto& point = f.points[f.next++ % f.points.size()];
+	for (const auto& obj : f.objects) {
+		doNotOptimize(obj->containsPoint(BoundingBoxKind::Clickable, point));
+	}
+});
+
+const Benchmark skeletonStep("SkeletonDrawable::step biggest skeleton", [] {
+	auto* skeleton = fixture().biggestSkeleton;
+	skeleton->wake(); // otherwise a static pose would fall asleep after a second
+	doNotOptimize(skeleton->step());
+});
+
+const Benchmark skeletonDraw("SkeletonDrawable::draw biggest skeleton", [] {
+	auto& f = fixture();
+	const auto context = f.frameBuffer.use();
+	f.biggestSkeleton->draw();
+});
+
+const Benchmark backupLuaTable("Game::backupLuaTable globals", [] {
+	auto& f = fixture();
+	doNotOptimize(f.game->backupLuaTable(f.game->lua_state->globals(), ""));
+});
+
+// What every click on an object with a script cost before and after the ScriptCache, without
+// running the script itself
+const Benchmark scriptMiss("ScriptCache miss banana_clicked.lua", [] {
+	auto& lua = *fixture().game->lua_state;
+	static ScriptCache cache; // after the fixture, so that it's destroyed before the Lua state
+	cache.clear();
+	doNotOptimize(cache.get(lua, "banana_clicked"));
+});
+
+const Benchmark scriptHit("ScriptCache hit banana_clicked.lua", [] {
+	auto& lua = *fixture().game->lua_state;
+	static ScriptCache cache;
+	doNotOptimize(cache.get(lua, "banana_clicked"));
+});
+
+/// Objects of a Spine project from the start scene at random heights, sorted by their own
+/// DepthOrder. Only their layer changes, setPosition() would also update their bounds.
+struct DepthScene {
+	explicit DepthScene(const size_t count) {
+		auto& f = fixture();
+		for (const auto& obj : f.objects) {
+			// No navigation bounds, so that setPosition() doesn't change the nav mesh
+			if (!obj->spineData->boundingBoxKinds.has(BoundingBoxKind::Walkable) &&
+			    !obj->spineData->boundingBoxKinds.has(BoundingBoxKind::NonWalkable)) {
+				spine = obj->getName();
+				break;
+			}
+		}
+		if (spine.empty()) {
+			return;
+		}
+		std::mt19937 random(0);
+		std::uniform_real_distribution<double> y(0, 2000);
+		for (size_t i = 0; i < count; ++i) {
+			std::shared_ptr<SpineObject> obj =
+			    f.game->currentScene->createObject(spine, "depth_" + std::to_string(i), 1);
+			obj->setPosition(jngl::Vec2(0, y(random)));
+			order.insert(obj);
+			objects.push_back(std::move(obj));
+		}
+	}
+
+	/// Moves `moving` objects to the other layer and sorts them in again
+	void update(const size_t moving) {
+		for (size_t i = 0; i < moving && !objects.empty(); ++i) {
+			auto& obj = objects[next++ % objects.size()];
+			obj->setLayer(obj->getLayer() == 1 ? 2 : 1);
+		}
+		order.update();
+		doNotOptimize(order.size());
+	}
+
+	std::string spine;
+	std::vector<std::shared_ptr<SpineObject>> objects;
+	DepthOrder order;
+	size_t next = 0;
+};
+
+DepthScene& depthScene(const size_t count) {
+	static std::map<size_t, std::unique_ptr<DepthScene>> scenes;
+	auto& scene = scenes[count];
+	if (!scene) {
+		scene = std::make_unique<DepthScene>(count);
+	}
+	return *scene;
+}
+
+const Benchmark depthStatic1000("DepthOrder::update 1000 objects static",
+                                [] { depthScene(1000).update(0); });
+const Benchmark depthMoving1000("DepthOrder::update 1000 objects 10 moving",
+                                [] { depthScene(1000).update(10); });
+const Benchmark depthStatic10000("DepthOrder::update 10000 objects static",
+                                 [] { depthScene(10000).update(0); });
+const Benchmark depthMoving10000("DepthOrder::update 10000 objects 10 moving",
+                                 [] { depthScene(10000).update(10); });
+
+// Last, since the objects the other benchmarks use are no longer part of the game afterwards
+const Benchmark sceneLoad("Scene load start scene", [] {
+	auto& f = fixture();
+	f.game->nextScene = f.startScene;
+	f.game->step();
+});
+
+} // namespace
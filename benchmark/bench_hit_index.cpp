@@ -0,0 +1,61 @@
+#include "benchmark.hpp"
+
+#include "hit_index.hpp"
+
+#include <map>
+#include <memory>
+#include <random>
+
+namespace {
+
+/// Objects with a size of 50 to 400 px scattered over a scene of 8000x2000 px
+struct HitScene {
+	explicit HitScene(const uint32_t objects) {
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> x(0, 8000);
+		std::uniform_real_distribution<float> y(0, 2000);
+		std::uniform_real_distribution<float> size(50, 400);
+		for (uint32_t i = 0; i < objects; ++i) {
+			const float left = x(random);
+			const float top = y(random);
+			index.update(ObjectHandle{ i, 1 },
+			             HitIndex::Box{ left, top, left + size(random), top + size(random) }, false);
+		}
+		// A background covering the whole scene, like every scene has
+		index.update(ObjectHandle{ objects, 1 }, HitIndex::Box{ 0, 0, 8000, 2000 }, false);
+		for (int i = 0; i < 64; ++i) {
+			points.emplace_back(x(random), y(random));
+		}
+	}
+
+	void query() {
+		result.clear();
+		index.query(points[nextPoint++ % points.size()], false, result);
+		doNotOptimize(result);
+	}
+
+	HitIndex index;
+	std::vector<jngl::Vec2> points;
+	size_t nextPoint = 0;
+	std::vector<ObjectHandle> result;
+};
+
+HitScene& scene(const uint32_t objects) {
+	static std::map<uint32_t, std::unique_ptr<HitScene>> scenes;
+	auto& scene = scenes[objects];
+	if (!scene) {
+		scene = std::make_unique<HitScene>(objects);
+	}
+	return *scene;
+}
+
+const Benchmark query100("HitIndex::query 100 objects", [] { scene(100).query(); });
+const Benchmark query1000("HitIndex::query 1000 objects", [] { scene(1000).query(); });
+
+const Benchmark move("HitIndex::update moving object", [] {
+	static float x = 0;
+	x = x > 7000 ? 0 : x + 7;
+	scene(100).index.update(ObjectHandle{ 0, 1 }, HitIndex::Box{ x, 500, x + 300, 800 }, false);
+});
+
+} // namespace
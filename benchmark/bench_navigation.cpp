@@ -0,0 +1,125 @@
+#include "benchmark.hpp"
+
+#include "navmesh.hpp"
+#include "visibility_graph.hpp"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <numbers>
+#include <random>
+
+namespace {
+
+/// Closed polygon, like Background::updateCorners() creates them
+std::vector<jngl::Vec2> circle(const jngl::Vec2 center, const double radius, const int corners) {
+	std::vector<jngl::Vec2> polygon;
+	for (int i = 0; i <= corners; ++i) {
+		const double angle = 2 * std::numbers::pi * (i % corners) / corners;
+		polygon.emplace_back(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+	}
+	return polygon;
+}
+
+bool contains(const std::vector<jngl::Vec2>& polygon, const jngl::Vec2 point) {
+	bool inside = false;
+	for (size_t i = 0, j = polygon.size() - 2; i + 1 < polygon.size(); j = i++) {
+		const auto& a = polygon[i];
+		const auto& b = polygon[j];
+		if ((a.y > point.y) != (b.y > point.y) &&
+		    point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+/// A big walkable area with a grid of obstacles, larger than any of our scenes
+struct NavigationScene {
+	explicit NavigationScene(const int obstaclesPerRow)
+	: graph([this](const jngl::Vec2 position) { return isWalkable(position); }) {
+		walkableArea = circle({ 0, 0 }, 3000, 64);
+		const double spacing = 4000.0 / obstaclesPerRow;
+		for (int x = 0; x < obstaclesPerRow; ++x) {
+			for (int y = 0; y < obstaclesPerRow; ++y) {
+				obstacles.push_back(circle({ -2000 + (x + 0.5) * spacing, -2000 + (y + 0.5) * spacing },
+				                           spacing / 4, 6));
+			}
+		}
+		graph.setWalkableArea(walkableArea);
+		graph.setObstacles(obstacles);
+		mesh.build(walkableArea, obstacles);
+
+		std::mt19937 random(0);
+		std::uniform_real_distribution<double> coordinate(-2000, 2000);
+		while (queries.size() < 64) {
+			const jngl::Vec2 start(coordinate(random), coordinate(random));
+			const jngl::Vec2 target(coordinate(random), coordinate(random));
+			if (isWalkable(start) && isWalkable(target)) {
+				queries.emplace_back(start, target);
+			}
+		}
+	}
+
+	bool isWalkable(const jngl::Vec2 position) const {
+		if (!contains(walkableArea, position)) {
+			return false;
+		}
+		for (const auto& obstacle : obstacles) {
+			if (contains(obstacle, position)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<jngl::Vec2> walkableArea;
+	std::vector<std::vector<jngl::Vec2>> obstacles;
+	VisibilityGraph graph;
+	NavMesh mesh;
+	std::vector<std::pair<jngl::Vec2, jngl::Vec2>> queries;
+	size_t nextQuery = 0;
+
+	void findPath() {
+		const auto& [start, target] = queries[nextQuery++ % queries.size()];
+		doNotOptimize(graph.findPath(start, target));
+	}
+
+	void findPathOnMesh() {
+		const auto& [start, target] = queries[nextQuery++ % queries.size()];
+		doNotOptimize(mesh.findPath(start, target));
+	}
+};
+
+NavigationScene& scene(const int obstaclesPerRow) {
+	static std::map<int, std::unique_ptr<NavigationScene>> scenes;
+	auto& scene = scenes[obstaclesPerRow];
+	if (!scene) {
+		scene = std::make_unique<NavigationScene>(obstaclesPerRow);
+		scene->graph.getCorners(); // build the graph outside of the timed loop
+	}
+	return *scene;
+}
+
+const Benchmark findPath4("VisibilityGraph::findPath 16 obstacles", [] { scene(4).findPath(); });
+const Benchmark findPath8("VisibilityGraph::findPath 64 obstacles", [] { scene(8).findPath(); });
+const Benchmark findPath12("VisibilityGraph::findPath 144 obstacles",
+                           [] { scene(12).findPath(); });
+
+const Benchmark build8("VisibilityGraph build 64 obstacles", [] {
+	auto& s = scene(8);
+	s.graph.invalidate();
+	doNotOptimize(s.graph.getCorners());
+});
+
+const Benchmark meshPath4("NavMesh::findPath 16 obstacles", [] { scene(4).findPathOnMesh(); });
+const Benchmark meshPath8("NavMesh::findPath 64 obstacles", [] { scene(8).findPathOnMesh(); });
+const Benchmark meshPath12("NavMesh::findPath 144 obstacles",
+                           [] { scene(12).findPathOnMesh(); });
+
+const Benchmark meshBuild8("NavMesh::build 64 obstacles", [] {
+	auto& s = scene(8);
+	doNotOptimize(s.mesh.build(s.walkableArea, s.obstacles));
+});
+
+} // namespace
@@ -0,0 +1,32 @@
+#include "benchmark.hpp"
+
+#include "polylabel.hpp"
+
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+/// Closed polygon around the origin, a star if innerRadius differs from outerRadius
+std::vector<jngl::Vec2> star(const int points, const double outerRadius, const double innerRadius) {
+	std::vector<jngl::Vec2> polygon;
+	for (int i = 0; i < points * 2; ++i) {
+		const double angle = std::numbers::pi * i / points;
+		const double radius = i % 2 == 0 ? outerRadius : innerRadius;
+		polygon.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+	}
+	return polygon;
+}
+
+// Same precision as the hotspots in SkeletonDrawable::updateHotspots()
+const Benchmark convex("mapbox::polylabel convex 12 corners", [] {
+	static const std::vector<std::vector<jngl::Vec2>> polygon{ star(6, 200, 200) };
+	doNotOptimize(mapbox::polylabel(polygon, 0.5));
+});
+
+const Benchmark concave("mapbox::polylabel concave 24 corners", [] {
+	static const std::vector<std::vector<jngl::Vec2>> polygon{ star(12, 200, 80) };
+	doNotOptimize(mapbox::polylabel(polygon, 0.5));
+});
+
+} // namespace
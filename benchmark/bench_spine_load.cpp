@@ -0,0 +1,96 @@
+#include "benchmark.hpp"
+
+#include "skeleton_drawable.hpp"
+
+#include <jngl.hpp>
+#include <spine/spine.h>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace {
+
+/// Atlas and both exports of a Spine project in data/, read once so that only the parsing is timed
+struct Project {
+	explicit Project(const std::string& name)
+	: atlas((name + "/" + name + ".atlas").c_str(), &SkeletonDrawable::textureLoader),
+	  json(jngl::readAsset(name + "/" + name + ".json").str()),
+	  skel(jngl::readAsset(name + "/" + name + ".skel").str()) {
+	}
+
+	spine::Atlas atlas;
+	std::string json;
+	/// Empty if prepare_assets.py hasn't written a binary export
+	std::string skel;
+};
+
+Project& project(const std::string& name) {
+	static std::map<std::string, std::unique_ptr<Project>> projects;
+	auto& project = projects[name];
+	if (!project) {
+		useDataFolder();
+		project = std::make_unique<Project>(name);
+	}
+	return *project;
+}
+
+std::unique_ptr<spine::SkeletonData> parse(Project& project, const bool binary) {
+	if (binary) {
+		spine::SkeletonBinary reader(project.atlas);
+		return std::unique_ptr<spine::SkeletonData>(
+		    reader.readSkeletonData(reinterpret_cast<const unsigned char*>(project.skel.data()),
+		                            static_cast<int>(project.skel.size())));
+	}
+	spine::SkeletonJson reader(project.atlas);
+	return std::unique_ptr<spine::SkeletonData>(reader.readSkeletonData(project.json.c_str()));
+}
+
+/// Bytes currently allocated on the heap, 0 where glibc can't tell
+size_t heapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+	return mallinfo2().uordblks;
+#else
+	return 0;
+#endif
+}
+
+/// Parses the export once per call. Prints how much heap the parsed SkeletonData keeps alive on
+/// the first call.
+void benchmarkParse(const std::string& name, const bool binary) {
+	auto& p = project(name);
+	const char* extension = binary ? "skel" : "json";
+	if (binary && p.skel.empty()) {
+		static std::map<std::string, bool> warned;
+		if (!std::exchange(warned[name], true)) {
+			std::printf("%s/%s.skel missing, run prepare_assets.py with a Spine installation\n",
+			            name.c_str(), name.c_str());
+		}
+		return;
+	}
+	static std::map<std::string, bool> measured;
+	if (!std::exchange(measured[name + extension], true)) {
+		const size_t before = heapInUse();
+		const auto data = parse(p, binary);
+		const size_t after = heapInUse();
+		std::printf("%s.%s: %zu KB SkeletonData\n", name.c_str(), extension,
+		            (after - before) / 1024);
+		return;
+	}
+	doNotOptimize(parse(p, binary));
+}
+
+const Benchmark spineboyJson("SkeletonJson spineboy-pro",
+                             [] { benchmarkParse("spineboy-pro", false); });
+const Benchmark spineboyBinary("SkeletonBinary spineboy-pro",
+                               [] { benchmarkParse("spineboy-pro", true); });
+const Benchmark alpacaJson("SkeletonJson alpaca", [] { benchmarkParse("alpaca", false); });
+const Benchmark alpacaBinary("SkeletonBinary alpaca", [] { benchmarkParse("alpaca", true); });
+
+} // namespace
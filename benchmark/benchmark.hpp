@@ -0,0 +1,30 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+/// Registers a micro benchmark at static initialization, e.g.
+///   static Benchmark b("name", [] { ... });
+/// fn is one operation. It's called in batches that run long enough for the clock to be precise,
+/// the median time per operation of all batches is reported.
+class Benchmark {
+public:
+	Benchmark(std::string name, std::function<void()> fn);
+
+	/// Runs all benchmarks whose name contains filter and prints ns/op for each
+	static int runAll(const std::string& filter);
+};
+
+/// Changes into the data folder of the repository, wherever the benchmarks are run from
+void useDataFolder();
+
+/// Keeps the compiler from optimizing away a result that is never used
+template <class T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const T* sink;
+	sink = &value;
+#endif
+}
@@ -0,0 +1,80 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+namespace {
+
+struct Registered {
+	std::string name;
+	std::function<void()> fn;
+};
+
+std::vector<Registered>& registry() {
+	static std::vector<Registered> benchmarks;
+	return benchmarks;
+}
+
+using Clock = std::chrono::steady_clock;
+
+double secondsFor(const std::function<void()>& fn, const size_t iterations) {
+	const auto start = Clock::now();
+	for (size_t i = 0; i < iterations; ++i) {
+		fn();
+	}
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+Benchmark::Benchmark(std::string name, std::function<void()> fn) {
+	registry().push_back(Registered{ std::move(name), std::move(fn) });
+}
+
+int Benchmark::runAll(const std::string& filter) {
+	constexpr double MIN_BATCH_SECONDS = 0.02;
+	constexpr int BATCHES = 15;
+
+	std::printf("%-48s %14s %14s %14s\n", "benchmark", "median ns/op", "min ns/op", "max ns/op");
+	for (const auto& benchmark : registry()) {
+		if (benchmark.name.find(filter) == std::string::npos) {
+			continue;
+		}
+		// Warm up caches and grow the batch until it's long enough to be timed reliably
+		size_t iterations = 1;
+		while (secondsFor(benchmark.fn, iterations) < MIN_BATCH_SECONDS) {
+			iterations *= 2;
+		}
+		std::vector<double> nsPerOp;
+		for (int i = 0; i < BATCHES; ++i) {
+			nsPerOp.push_back(secondsFor(benchmark.fn, iterations) * 1e9 /
+			                  static_cast<double>(iterations));
+		}
+		std::sort(nsPerOp.begin(), nsPerOp.end());
+		std::printf("%-48s %14.1f %14.1f %14.1f\n", benchmark.name.c_str(), nsPerOp[BATCHES / 2],
+		            nsPerOp.front(), nsPerOp.back());
+		std::fflush(stdout);
+	}
+	return 0;
+}
+
+void useDataFolder() {
+	static bool changed = false;
+	if (changed) {
+		return; // the paths are relative
+	}
+	for (const auto* folder : { "../data", "../../data", "../../../../data", "data" }) {
+		if (std::filesystem::exists(folder)) {
+			std::filesystem::current_path(folder);
+			break;
+		}
+	}
+	changed = true;
+}
+
+int main(int argc, char** argv) {
+	return Benchmark::runAll(argc > 1 ? argv[1] : "");
+}
@@ -43,6 +43,10 @@ RHUBARB_OUT = "data/rhubarb/"
 
 SPINE_THREADS = cpu_count()
 
+# Also write precompiled data/scripts/<name>.luac, which the engine loads instead of the .lua file.
+# luac has to be built for the same Lua version as the engine.
+COMPILE_LUA = False
+
 set_read_only = True
 # could be "linux", "linux2", "linux3", ...
 if sys.platform.startswith("linux"):
@@ -468,6 +472,14 @@ def spine_export(
         os.path.abspath(f"./data/{name}/"),
         "-e",
         "./data-src/spine_export_template.export.json",
+        # Binary export next to the JSON, which is loaded much faster by the engine
+        "-i",
+        file,
+        "-m",
+        "-o",
+        os.path.abspath(f"./data/{name}/"),
+        "-e",
+        "./data-src/spine_export_binary_template.export.json",
     ]
     with contextlib.suppress(Exception):
         shutil.rmtree(f"./data/{name}/", ignore_errors=True)
@@ -478,6 +490,9 @@ def spine_export(
             Path(f"./data/{name}/{name}.atlas").chmod(
                 S_IREAD | S_IRGRP | S_IROTH | S_IWUSR
             )
+            Path(f"./data/{name}/{name}.skel").chmod(
+                S_IREAD | S_IRGRP | S_IROTH | S_IWUSR
+            )
     p = subprocess.Popen(
         command, stdout=subprocess.PIPE, stdin=subprocess.PIPE, stderr=subprocess.STDOUT
     )
@@ -500,6 +515,7 @@ def spine_export(
         with contextlib.suppress(Exception):
             Path(f"./data/{name}/{name}.json").chmod(S_IREAD | S_IRGRP | S_IROTH)
             Path(f"./data/{name}/{name}.atlas").chmod(S_IREAD | S_IRGRP | S_IROTH)
+            Path(f"./data/{name}/{name}.skel").chmod(S_IREAD | S_IRGRP | S_IROTH)
 
     return errors, {name: {file}}, f"./data/{name}/{name}.json", db_out
 
@@ -573,6 +589,12 @@ def copy_script(file: str) -> None:
         if set_read_only:
             Path(f"./data/scripts/{name}").chmod(S_IREAD | S_IRGRP | S_IROTH)
 
+        # A stale .luac would shadow the new script
+        compiled = Path(f"./data/scripts/{stem}.luac")
+        compiled.unlink(missing_ok=True)
+        if COMPILE_LUA and p.returncode == 0:
+            subprocess.run([LUA, "-o", str(compiled), file], check=False)
+
 
 def copy_folder(src: str, des: str) -> None:
     for root, _dirs, files in walk(src):
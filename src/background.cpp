@@ -3,25 +3,28 @@
 #include "jngl/matrix.hpp"
 #include "skeleton_drawable.hpp"
 #include "game.hpp"
+#include "render_queue.hpp"
+#include "profiler.hpp"
 
-#include <cmath>
-
-Background::Background(const std::shared_ptr<Game> &game, const std::string &spine_file) : SpineObject(game, spine_file, "Background")
+Background::Background(const std::shared_ptr<Game> &game, const std::string &spine_file)
+: SpineObject(game, spine_file, "Background"),
+  navigation([this](jngl::Vec2 position) { return is_walkable(position); })
 {
-    stepSpineAndNavigation();
+    markBoundsDirty();
+    updateNavigation();
 }
 
-void Background::stepSpineAndNavigation()
+void Background::updateNavigation()
 {
-    skeleton->step();
-    bounds->update(*skeleton->skeleton, true);
+    ALPACA_PROFILE_ZONE("Navigation");
     updateCorners();
     updateForbiddenCorners();
 }
 
 bool Background::step(bool force)
 {
-    stepSpineAndNavigation();
+    // The skeleton and the bounds have already been updated by Game::animateObjects
+    updateNavigation();
     return stepClickableRegions(force) || deleted;
 }
 
@@ -46,14 +49,10 @@ bool Background::stepClickableRegions(bool force)
 
         if (_game->pointer && _game->pointer->primaryPressed() && visible && !_game->pointer->isPrimaryAlreadyHandled())
         {
-			const jngl::Vec2 mousePos = _game->pointer->getWorldPosition();
-			const auto* collision = spSkeletonBounds_containsPointNotMatchingName(
-			    bounds.get(), "walkable_area",
-			    static_cast<float>(mousePos.x) - static_cast<float>(position.x),
-			    static_cast<float>(mousePos.y) - static_cast<float>(position.y));
+			const auto& hit = _game->getPointerHit();
 			// TODO Double Click on Regions
-			if (collision) {
-				collision_script = collision->getName().buffer();
+			if (hit.object.get() == this) {
+				collision_script = hit.box->getName().buffer();
 				jngl::debug("clicked interactable region {}", collision_script);
 				_game->pointer->setPrimaryHandled();
 				_game->runAction(collision_script, getptr());
@@ -83,12 +82,16 @@ void Background::draw() const {
                 {
                     _game->hotspot->draw(pos);
                 }else{
+                    RenderQueue::handle().flush();
                     jngl::drawCircle(pos, 5);
                 }
             }
         }
 
 #ifndef NDEBUG
+        if (_game->enablezMapDebugDraw || _game->enableDebugDraw) {
+            RenderQueue::handle().flush();
+        }
         if (_game->enablezMapDebugDraw && sprite) {
             sprite->draw(mv);
         }
@@ -96,21 +99,30 @@ void Background::draw() const {
         if (_game->enableDebugDraw) {
             jngl::setColor(255, 0, 0);
             if (_game->player) {
-                for (auto corner : corners) {
+                for (auto corner : navigation.getWalkableArea()) {
                     if (hasPathTo(_game->player->getPosition(), corner)) {
                         jngl::drawLine(mv, _game->player->getPosition(), corner);
                     }
                 }
 
+                jngl::setColor(0, 255, 0);
+                const auto& vertices = navMesh.getVertices();
+                for (const auto& triangle : navMesh.getTriangles()) {
+                    for (size_t i = 0; i < 3; i++) {
+                        jngl::drawLine(mv, vertices[triangle.vertices[i]],
+                                       vertices[triangle.vertices[(i + 1) % 3]]);
+                    }
+                }
+
                 jngl::setColor(0, 0, 0);
-                for (const auto& forbidden_area : forbidden_corners) {
+                for (const auto& forbidden_area : navigation.getObstacles()) {
                     for (size_t i = 1; i < forbidden_area.size(); i++) {
                         jngl::drawLine(mv, forbidden_area.at(i), forbidden_area.at(i - 1));
                     }
                 }
 
                 jngl::setColor(0, 0, 255);
-                for (const auto& forbidden_area : forbidden_corners) {
+                for (const auto& forbidden_area : navigation.getObstacles()) {
                     for (auto forbidden_corner : forbidden_area) {
                         if (hasPathTo(_game->player->getPosition(), forbidden_corner)) {
                             jngl::drawLine(mv, _game->player->getPosition(), forbidden_corner);
@@ -135,216 +147,61 @@ double Background::getZ() const
     return -100.0;
 }
 
-enum class Result {
-    INTERSECTION,
-    NO_INTERSECTION,
-    TWO_POINTS_EQUAL,
-};
-
-// Quelle: https://www.youtube.com/watch?v=c065KoXooSw
-static Result lineIntersection(jngl::Vec2 a, jngl::Vec2 b, jngl::Vec2 c, jngl::Vec2 d)
-{
-    if (boost::qvm::mag_sqr(a - c) < 0.1) {
-        return boost::qvm::mag_sqr(b - d) < 0.1 ? Result::TWO_POINTS_EQUAL
-                                                : Result::NO_INTERSECTION;
-    }
-    if (boost::qvm::mag_sqr(a - d) < 0.1) {
-        return boost::qvm::mag_sqr(b - c) < 0.1 ? Result::TWO_POINTS_EQUAL
-                                                : Result::NO_INTERSECTION;
-    }
-    if (boost::qvm::mag_sqr(b - d) < 0.1 || boost::qvm::mag_sqr(b - c) < 0.1) {
-        return Result::NO_INTERSECTION;
-    }
-    jngl::Vec2 const r = (b - a);
-    jngl::Vec2 const s = (d - c);
-
-    double const e = r.x * s.y - r.y * s.x;
-    double const u = ((c.x - a.x) * r.y - (c.y - a.y) * r.x) / e;
-    double const t = ((c.x - a.x) * s.y - (c.y - a.y) * s.x) / e;
-
-    // Intersection Point a + t * r
-    return (0 <= u && u <= 1 && 0 <= t && t <= 1) ? Result::INTERSECTION
-                                                  : Result::NO_INTERSECTION;
-}
-
-Node::Node(jngl::Vec2 coordinates_, Node *parent_) : coordinates(coordinates_), parent(parent_)
-{
-
-    G = H = 0;
-}
-
-int Node::getScore() const
-{
-    return G + H;
-}
-
 std::deque<jngl::Vec2> Background::getPathToTarget(jngl::Vec2 start, jngl::Vec2 target) const
 {
-    std::deque<jngl::Vec2> path;
-
+    ALPACA_PROFILE_ZONE("Navigation");
     if (!is_walkable(target))
     {
-        return path;
+        return {};
     }
-
-    Node *current = nullptr;
-    std::vector<Node *> openSet;
-    std::vector<Node *> closedSet;
-
-    openSet.push_back(new Node(start));
-
-    while (!openSet.empty())
+    updateNavMesh();
+    if (!navMesh.empty())
     {
-        auto current_it = openSet.begin();
-        current = *current_it;
-
-        for (auto it = openSet.begin(); it != openSet.end(); it++)
-        {
-            auto *const node = *it;
-            if (node->getScore() <= current->getScore())
-            {
-                current = node;
-                current_it = it;
-            }
-        }
-
-        if (boost::qvm::mag_sqr(current->coordinates - target) < 1)
-        {
-            break;
-        }
-
-        closedSet.push_back(current);
-        openSet.erase(current_it);
-
-        auto directions = corners;
-        for (const auto &forbidden_area : forbidden_corners)
+        auto path = navMesh.findPath(start, target);
+        if (!path.empty())
         {
-            directions.insert(directions.end(), forbidden_area.begin(), forbidden_area.end());
+            return path;
         }
-        directions.push_back(target);
-        for (auto direction : directions)
-        {
-            const auto visited = findNodeOnList(closedSet, direction);
-            if (visited || !hasPathTo(current->coordinates, direction)) {
-                continue;
-            }
-
-            const int totalCost = current->G + heuristic(current->coordinates, direction);
-
-            Node *successor = findNodeOnList(openSet, direction);
-            if (successor == nullptr)
-            {
-                successor = new Node(direction, current);
-                successor->G = totalCost;
-                successor->H = heuristic(successor->coordinates, target);
-                openSet.push_back(successor);
-            }
-            else if (totalCost < successor->G)
-            {
-                successor->parent = current;
-                successor->G = totalCost;
-            }
-        }
-    }
-
-    while (current != nullptr)
-    {
-        path.emplace_front(current->coordinates);
-        current = current->parent;
     }
-
-    releaseNodes(openSet);
-    releaseNodes(closedSet);
-
-    return path;
+    // e.g. the player stands slightly outside of the walkable area
+    return navigation.findPath(start, target);
 }
 
-void Background::releaseNodes(std::vector<Node *> &nodes_)
+void Background::updateNavMesh() const
 {
-    for (auto it = nodes_.begin(); it != nodes_.end();)
+    if (!navMeshDirty)
     {
-        delete *it;
-        it = nodes_.erase(it);
+        return;
     }
-}
-
-Node *Background::findNodeOnList(const std::vector<Node *> &nodes_, jngl::Vec2 coordinates_)
-{
-    for (const auto node : nodes_)
+    navMeshDirty = false;
+    if (!navMesh.build(navigation.getWalkableArea(), navigation.getObstacles()))
     {
-        if (boost::qvm::mag_sqr(node->coordinates - coordinates_) < 0.5)
-        {
-            return node;
-        }
+        jngl::debug("Couldn't triangulate the walkable area of {}, obstacles might overlap each other "
+                    "or its border. Using the visibility graph instead.", spine_name);
     }
-    return nullptr;
-}
-
-int Background::heuristic(jngl::Vec2 start, jngl::Vec2 target)
-{
-    return std::sqrt((start.x - target.x) * (start.x - target.x) + (start.y - target.y) * (start.y - target.y));
 }
 
 bool Background::hasPathTo(jngl::Vec2 start, jngl::Vec2 target) const
 {
-    if (corners.empty())
-    {
-        return false;
-    }
-    if (boost::qvm::mag_sqr(target - start) < 0.1) {
-        return false;
-    }
-
-    bool twoPointsEqual = false;
-    for (size_t i = 0; i < corners.size() - 1; i++)
-    {
-        // do we intersect with an edge of the walkable area?
-        switch (lineIntersection(start, target, corners.at(i), corners.at(i + 1)))
-        {
-        case Result::INTERSECTION:
-            return false;
-        case Result::NO_INTERSECTION:
-            break;
-        case Result::TWO_POINTS_EQUAL:
-            twoPointsEqual = true;
-            break;
-        }
-    }
-
-    if (!forbidden_corners.empty())
-    {
-        for (auto forbidden_corner : forbidden_corners){
-            for (size_t i = 0; i < forbidden_corner.size() - 1; i++)
-            {
-                switch (lineIntersection(start, target, forbidden_corner.at(i), forbidden_corner.at(i + 1)))
-                {
-                using enum Result;
-                case Result::INTERSECTION:
-                    return false;
-                case Result::NO_INTERSECTION:
-                    break;
-                case Result::TWO_POINTS_EQUAL:
-                    twoPointsEqual = true;
-                    break;
-                }
-            }
-        }
-    }
-
-    if (twoPointsEqual) {
-        return true;
-    }
-    auto direction = boost::qvm::normalized(target - start);
-    return is_walkable(start + direction); // move 1 pixel and see if that wouldn't leave the walkable area
+    return navigation.hasPathTo(start, target);
 }
 
 void Background::updateCorners() {
-    corners.clear();
+    std::vector<jngl::Vec2> corners;
     spine::Array<spine::BoundingBoxAttachment*>& boundingBoxes = bounds->getBoundingBoxes();
     spine::Array<spine::Polygon*>& polygons = bounds->getPolygons();
     for (size_t i = 0; i < boundingBoxes.size(); i++) {
-        const auto* polygonName = boundingBoxes[i]->getName().buffer();
-        if (polygonName == std::string("walkable_area")) {
+        if (getBoundingBoxKind(i) == BoundingBoxKind::Walkable) {
+            // Compare in place first, so that there's nothing to allocate if the area didn't change
+            const auto& current = navigation.getWalkableArea();
+            bool same = current.size() == static_cast<size_t>(polygons[i]->_count / 2 + 1);
+            for (int j = 0; same && j < polygons[i]->_count; j += 2) {
+                same = current[j / 2].x == polygons[i]->_vertices[j + 0] &&
+                       current[j / 2].y == polygons[i]->_vertices[j + 1];
+            }
+            if (same) {
+                return;
+            }
             for (int j = 0; j < polygons[i]->_count; j += 2) {
                 corners.emplace_back(polygons[i]->_vertices[j + 0], polygons[i]->_vertices[j + 1]);
             }
@@ -353,37 +210,32 @@ void Background::updateCorners() {
             break; // there can only be one walkable area per scene
         }
     }
+    if (navigation.setWalkableArea(std::move(corners))) {
+        navMeshDirty = true;
+    }
 }
 
 void Background::updateForbiddenCorners() {
-    forbidden_corners.clear();
-    if (auto _game = game.lock()) {
-        for (const auto& obj : _game->gameObjects) {
-            if (!obj->getVisible()) {
-                continue;
-            }
-            auto& polygons = obj->bounds->getPolygons();
-            auto& boundingBoxes = obj->bounds->getBoundingBoxes();
-            for (size_t i = 0; i < boundingBoxes.size(); i++) {
-                const auto* polygonName = boundingBoxes[i]->getName().buffer();
-                if (polygonName == std::string("non_walkable_area")) {
-                    std::vector<jngl::Vec2> forbidden_area;
-                    for (int j = 0; j < polygons[i]->_count; j += 2) {
-                        forbidden_area.emplace_back(jngl::Vec2(polygons[i]->_vertices[j + 0], polygons[i]->_vertices[j + 1]) + obj->getPosition());
-                    }
-                    // Add first to the back again.
-                    forbidden_area.emplace_back(jngl::Vec2(polygons[i]->_vertices[0], polygons[i]->_vertices[1]) + obj->getPosition());
-                    forbidden_corners.emplace_back(std::move(forbidden_area));
-                }
-            }
-        }
+    auto _game = game.lock();
+    // Objects publish their obstacles themselves when they've changed, see SpineObject::updateBounds
+    if (!_game || obstacleRevision == _game->getObstacleRevision()) {
+        return;
+    }
+    obstacleRevision = _game->getObstacleRevision();
+    std::vector<std::vector<jngl::Vec2>> forbidden_corners;
+    for (const auto& obj : _game->gameObjects) {
+        const auto& obstacles = obj->getObstacles();
+        forbidden_corners.insert(forbidden_corners.end(), obstacles.begin(), obstacles.end());
+    }
+    // Drops the cached visibility graph and nav mesh only if an obstacle has actually changed
+    if (navigation.setObstacles(std::move(forbidden_corners))) {
+        navMeshDirty = true;
     }
 }
 
 bool Background::is_walkable(jngl::Vec2 position) const
 {
-    const auto walkableResult = spSkeletonBounds_containsPointMatchingName(bounds.get(), "walkable_area", static_cast<float>(position.x), static_cast<float>(position.y));
-    if (!walkableResult)
+    if (!containsPoint(BoundingBoxKind::Walkable, position))
     {
         return false;
     }
@@ -395,8 +247,7 @@ bool Background::is_walkable(jngl::Vec2 position) const
             if (!obj->getVisible()) {
                 continue;
             }
-            auto *non_walkable = spSkeletonBounds_containsPointMatchingName(obj->bounds.get(), "non_walkable_area", static_cast<float>(position.x) - static_cast<float>(obj->getPosition().x), static_cast<float>(position.y) - static_cast<float>(obj->getPosition().y));
-            if (non_walkable)
+            if (obj->containsPoint(BoundingBoxKind::NonWalkable, position - obj->getPosition()))
             {
                 return false;
             }
@@ -405,6 +256,6 @@ bool Background::is_walkable(jngl::Vec2 position) const
 
     // if there is an interactable region and a walkable spot,
     // just interact, don't walk there
-    return spSkeletonBounds_containsPointNotMatchingName(
-               bounds.get(), "walkable_area", static_cast<float>(position.x), static_cast<float>(position.y)) == nullptr;
+    return !containsPoint(BoundingBoxKind::Clickable, position) &&
+           !containsPoint(BoundingBoxKind::NonWalkable, position);
 }
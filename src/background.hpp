@@ -1,21 +1,12 @@
 #pragma once
 
 #include "spine_object.hpp"
+#include "navmesh.hpp"
+#include "visibility_graph.hpp"
 
 #include <jngl.hpp>
 #include <deque>
 
-struct Node
-{
-    int G;
-    int H;
-    jngl::Vec2 coordinates;
-    Node *parent;
-
-    explicit Node(jngl::Vec2 coordinates_, Node *parent_ = nullptr);
-    int getScore() const;
-};
-
 class Background : public SpineObject
 {
 public:
@@ -28,20 +19,25 @@ public:
     double getZ() const override;
 
     std::deque<jngl::Vec2> getPathToTarget(jngl::Vec2 start, jngl::Vec2 target) const;
+
+    /// Triangulates the walkable area again if it or an obstacle has changed
+    void updateNavMesh() const;
 #ifndef NDEBUG
     std::unique_ptr<jngl::Sprite> sprite;
 #endif
 private:
-    void stepSpineAndNavigation();
+    void updateNavigation();
 
-    std::vector<jngl::Vec2> corners;
-    std::vector<std::vector<jngl::Vec2>> forbidden_corners;
+    /// walkable_area of the background and non_walkable_area of all visible objects
+    VisibilityGraph navigation;
+    /// Built from the same polygons, used for path finding unless they couldn't be triangulated
+    mutable NavMesh navMesh;
+    mutable bool navMeshDirty = true;
+    /// Game::getObstacleRevision() the obstacles of navigation are from
+    std::optional<uint32_t> obstacleRevision;
 
     bool stepClickableRegions(bool force = false);
     void updateCorners();
     void updateForbiddenCorners();
     bool hasPathTo(jngl::Vec2 start, jngl::Vec2 target) const;
-    static void releaseNodes(std::vector<Node *> &nodes_);
-    static Node *findNodeOnList(const std::vector<Node *> &nodes_, jngl::Vec2 coordinates_);
-    static int heuristic(jngl::Vec2 start, jngl::Vec2 target);
 };
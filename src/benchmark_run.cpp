@@ -0,0 +1,184 @@
+#include "benchmark_run.hpp"
+
+#include "command_line.hpp"
+#include "game.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <numeric>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <sys/resource.h>
+#endif
+
+std::atomic<uint64_t> BenchmarkRun::allocations = 0;
+
+namespace {
+
+/// Pointer and walk targets change every that many frames
+constexpr int INPUT_INTERVAL = 90;
+
+std::string percentiles(std::vector<float> times) {
+	if (times.empty()) {
+		return "null";
+	}
+	std::sort(times.begin(), times.end());
+	const auto at = [&times](const double p) {
+		return times[std::min(times.size() - 1, static_cast<size_t>(p * times.size()))];
+	};
+	const double mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+	return std::format(R"({{"mean": {:.1f}, "p50": {:.1f}, "p90": {:.1f}, "p99": {:.1f}, "max": {:.1f}}})",
+	                   mean, at(0.5), at(0.9), at(0.99), times.back());
+}
+
+/// Peak resident set size in KiB, nullopt where we can't tell
+std::optional<long> peakMemory() {
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+		return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+		return usage.ru_maxrss;
+#endif
+	}
+#endif
+	return std::nullopt;
+}
+
+} // namespace
+
+std::optional<BenchmarkRun::Options> BenchmarkRun::parseArgs(const std::vector<std::string>& args) {
+	std::optional<Options> options;
+	for (size_t i = 0; i < args.size(); ++i) {
+		if (args[i] == "--benchmark") {
+			if (!options) {
+				options.emplace();
+			}
+			options->scene = argumentValue(args, i);
+		}
+	}
+	if (!options) {
+		return std::nullopt;
+	}
+	for (size_t i = 0; i < args.size(); ++i) {
+		if (args[i] == "--frames") {
+			options->frames = std::max(1, numericArgument<int>(args, i));
+		} else if (args[i] == "--seed") {
+			options->seed = numericArgument<uint32_t>(args, i);
+		} else if (args[i] == "--output") {
+			options->output = argumentValue(args, i);
+		}
+	}
+	return options;
+}
+
+BenchmarkRun::BenchmarkRun(std::shared_ptr<Game> game, Options options)
+: game(std::move(game)), options(std::move(options)), random(this->options.seed) {
+	std::srand(this->options.seed);
+	this->game->lua_state->script(std::format("math.randomseed({})", this->options.seed));
+	this->game->enable_fade = false;
+	this->game->nextScene = this->options.scene;
+	stepTimes.reserve(this->options.frames);
+	drawTimes.reserve(this->options.frames);
+	progress.setPos(jngl::Vec2(-100, 0));
+}
+
+void BenchmarkRun::step() {
+	if (frame == -1) {
+		// The first step loads the scene
+		const auto start = Clock::now();
+		game->step();
+		loadTime = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		if (game->pointer) {
+			// The first step has moved it to wherever the mouse is
+			game->pointer->ignoreMouse = true;
+			game->pointer->setPosition(jngl::Vec2(0, 0));
+			game->pointer->target_position = jngl::Vec2(0, 0);
+		}
+		allocationsAtStart = allocations.load(std::memory_order_relaxed);
+		frame = 0;
+		return;
+	}
+	if (frame == options.frames) {
+		return;
+	}
+
+	input();
+	const auto start = Clock::now();
+	game->step();
+	const auto stepped = Clock::now();
+	{
+		const auto context = frameBuffer.use();
+		game->draw();
+	}
+	const auto drawn = Clock::now();
+	stepTimes.push_back(std::chrono::duration<float, std::micro>(stepped - start).count());
+	drawTimes.push_back(std::chrono::duration<float, std::micro>(drawn - stepped).count());
+
+	if (++frame == options.frames) {
+		writeReport();
+		jngl::quit();
+	}
+}
+
+void BenchmarkRun::input() {
+	if (frame % INPUT_INTERVAL != 0) {
+		return;
+	}
+	const jngl::Vec2 screensize = jngl::getScreenSize();
+	std::uniform_real_distribution<double> x(-screensize.x / 2, screensize.x / 2);
+	std::uniform_real_distribution<double> y(-screensize.y / 2, screensize.y / 2);
+	const jngl::Vec2 target(x(random), y(random));
+	if (game->pointer) {
+		game->pointer->target_position = target;
+	}
+	if (game->player) {
+		// Searches the path right away, like a click does
+		game->player->addTargetPositionImmediately(
+		    (target + game->getCameraPosition()) / game->getCameraZoom(), std::nullopt);
+	}
+}
+
+void BenchmarkRun::draw() const {
+	progress.setText(std::format("Benchmark {}: frame {} of {}", options.scene,
+	                             std::max(frame, 0), options.frames));
+	progress.draw();
+}
+
+void BenchmarkRun::writeReport() const {
+	std::vector<float> frameTimes(stepTimes.size());
+	for (size_t i = 0; i < frameTimes.size(); ++i) {
+		frameTimes[i] = stepTimes[i] + drawTimes[i];
+	}
+#ifdef ALPACA_COUNT_ALLOCATIONS
+	const uint64_t allocated = allocations.load(std::memory_order_relaxed) - allocationsAtStart;
+	const std::string allocationCount = std::to_string(allocated);
+	const std::string allocationsPerFrame =
+	    std::format("{:.1f}", static_cast<double>(allocated) / options.frames);
+#else
+	const std::string allocationCount = "null";
+	const std::string allocationsPerFrame = "null";
+#endif
+	const auto memory = peakMemory();
+
+	std::ofstream file(options.output);
+	file << std::format("{{\n"
+	                    "  \"scene\": \"{}\",\n"
+	                    "  \"frames\": {},\n"
+	                    "  \"seed\": {},\n"
+	                    "  \"load_ms\": {:.1f},\n"
+	                    "  \"frame_us\": {},\n"
+	                    "  \"step_us\": {},\n"
+	                    "  \"draw_us\": {},\n"
+	                    "  \"allocations\": {},\n"
+	                    "  \"allocations_per_frame\": {},\n"
+	                    "  \"peak_rss_kib\": {}\n"
+	                    "}}\n",
+	                    options.scene, options.frames, options.seed, loadTime,
+	                    percentiles(frameTimes), percentiles(stepTimes), percentiles(drawTimes),
+	                    allocationCount, allocationsPerFrame,
+	                    memory ? std::to_string(*memory) : "null");
+	jngl::debug("Wrote benchmark results to {}", options.output.string());
+}
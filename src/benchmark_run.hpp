@@ -0,0 +1,64 @@
+#pragma once
+
+#include <jngl.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+class Game;
+
+/// pac --benchmark <scene> [--frames N] [--seed N] [--output file.json]
+///
+/// Loads a scene without the savegame (see Game::useSavegame) and runs a fixed number of frames
+/// with seeded pointer movements and walk targets. Every frame is drawn to an offscreen
+/// FrameBuffer, the window only shows the progress. Writes frame time percentiles, the step/draw
+/// split, allocations (null unless built with -DALPACA_COUNT_ALLOCATIONS=ON) and the peak memory
+/// to a JSON file and quits. Draw times are what the CPU spends on submitting, not GPU time.
+class BenchmarkRun : public jngl::Work {
+public:
+	struct Options {
+		std::string scene;
+		int frames = 600;
+		uint32_t seed = 0;
+		std::filesystem::path output = "benchmark.json";
+	};
+
+	/// Returns nullopt if there's no --benchmark in args, throws std::invalid_argument if an
+	/// option has no or a malformed value
+	static std::optional<Options> parseArgs(const std::vector<std::string>& args);
+
+	BenchmarkRun(std::shared_ptr<Game>, Options);
+
+	void step() override;
+	void draw() const override;
+
+	/// Counted by the operator new of the pac executable if it's built with
+	/// ALPACA_COUNT_ALLOCATIONS, stays 0 everywhere else
+	static std::atomic<uint64_t> allocations;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	/// Moves the pointer and lets the player walk to a random point every few seconds
+	void input();
+	void writeReport() const;
+
+	std::shared_ptr<Game> game;
+	Options options;
+	std::mt19937 random;
+	jngl::FrameBuffer frameBuffer{ jngl::getWindowSize() };
+
+	/// Microseconds per frame
+	std::vector<float> stepTimes;
+	std::vector<float> drawTimes;
+	float loadTime = 0;
+	uint64_t allocationsAtStart = 0;
+	int frame = -1;
+	mutable jngl::Text progress;
+};
@@ -0,0 +1,38 @@
+#include "bounding_box_kind.hpp"
+
+#include <string_view>
+
+void BoundingBoxKinds::add(spine::SkeletonData& skeletonData) {
+	auto& skins = skeletonData.getSkins();
+	for (size_t i = 0; i < skins.size(); ++i) {
+		auto entries = skins[i]->getAttachments();
+		while (entries.hasNext()) {
+			auto& entry = entries.next();
+			if (entry._attachment &&
+			    entry._attachment->getRTTI().isExactly(spine::BoundingBoxAttachment::rtti)) {
+				const auto* box = static_cast<spine::BoundingBoxAttachment*>(entry._attachment);
+				const auto kind = classify(box->getName());
+				kinds.emplace(box, kind);
+				present |= 1 << static_cast<int>(kind);
+			}
+		}
+	}
+}
+
+BoundingBoxKind BoundingBoxKinds::get(const spine::BoundingBoxAttachment& box) const {
+	if (const auto it = kinds.find(&box); it != kinds.end()) {
+		return it->second;
+	}
+	return classify(box.getName());
+}
+
+BoundingBoxKind BoundingBoxKinds::classify(const spine::String& name) {
+	const std::string_view view(name.buffer(), name.length());
+	if (view == "walkable_area") {
+		return BoundingBoxKind::Walkable;
+	}
+	if (view == "non_walkable_area") {
+		return BoundingBoxKind::NonWalkable;
+	}
+	return BoundingBoxKind::Clickable;
+}
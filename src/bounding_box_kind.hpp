@@ -0,0 +1,36 @@
+#pragma once
+
+#include <spine/spine.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+/// What a bounding box attachment of a Spine project is used for, derived from its name
+enum class BoundingBoxKind : uint8_t {
+	/// Any other name, clicking it runs the Lua action of the same name
+	Clickable,
+	/// "walkable_area" of a background
+	Walkable,
+	/// "non_walkable_area", an obstacle for path finding
+	NonWalkable,
+};
+
+/// Kinds of all bounding boxes of a Spine project, classified once when it's loaded so that hit
+/// tests and the navigation don't have to compare names
+class BoundingBoxKinds {
+public:
+	/// Classifies the bounding boxes of all skins
+	void add(spine::SkeletonData&);
+
+	/// Attachments which haven't been added are classified by their name
+	BoundingBoxKind get(const spine::BoundingBoxAttachment&) const;
+
+	/// Whether any skin has a bounding box of this kind
+	bool has(BoundingBoxKind kind) const { return (present & (1 << static_cast<int>(kind))) != 0; }
+
+	static BoundingBoxKind classify(const spine::String& name);
+
+private:
+	std::unordered_map<const spine::BoundingBoxAttachment*, BoundingBoxKind> kinds;
+	uint8_t present = 0;
+};
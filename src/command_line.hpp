@@ -0,0 +1,42 @@
+#pragma once
+
+#include <charconv>
+#include <cstdlib>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Returns the value following the option args[i] and advances i to it. Throws
+/// std::invalid_argument if the option is the last argument.
+inline const std::string& argumentValue(const std::vector<std::string>& args, size_t& i) {
+	if (i + 1 >= args.size()) {
+		throw std::invalid_argument(std::format("{} expects a value", args[i]));
+	}
+	return args[++i];
+}
+
+/// Like argumentValue(), but parses the value as a number and throws std::invalid_argument if it
+/// isn't one
+template <class T>
+T numericArgument(const std::vector<std::string>& args, size_t& i) {
+	const std::string& option = args[i];
+	const std::string& value = argumentValue(args, i);
+	T result{};
+	const char* const end = value.data() + value.size();
+	bool valid = false;
+	if constexpr (std::is_floating_point_v<T>) {
+		// Apple's libc++ doesn't have std::from_chars for floating point types
+		char* parsed = nullptr;
+		result = static_cast<T>(std::strtod(value.c_str(), &parsed));
+		valid = !value.empty() && parsed == end;
+	} else {
+		const auto [ptr, ec] = std::from_chars(value.data(), end, result);
+		valid = ec == std::errc() && ptr == end;
+	}
+	if (!valid) {
+		throw std::invalid_argument(std::format("{} expects a number, not \"{}\"", option, value));
+	}
+	return result;
+}
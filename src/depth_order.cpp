@@ -0,0 +1,61 @@
+#include "depth_order.hpp"
+
+#include "spine_object.hpp"
+
+#include <algorithm>
+
+void DepthOrder::insert(std::shared_ptr<SpineObject> object) {
+	object->depthDirty = false;
+	object->ordered = true;
+	const double z = object->getZ();
+	// upper_bound so that objects with the same z are drawn in insertion order
+	const auto index = std::upper_bound(keys.begin(), keys.end(), z) - keys.begin();
+	keys.insert(keys.begin() + index, z);
+	objects.insert(objects.begin() + index, std::move(object));
+}
+
+void DepthOrder::clear() {
+	for (const auto& object : objects) {
+		object->ordered = false;
+	}
+	objects.clear();
+	keys.clear();
+}
+
+void DepthOrder::update(const bool dropRemoved) {
+	// Take the objects whose z changed out of the array, keeping the order of all others
+	size_t write = 0;
+	for (size_t read = 0; read < objects.size(); ++read) {
+		auto& object = objects[read];
+		if (dropRemoved && object->removed) {
+			object->ordered = false;
+			object.reset();
+			continue;
+		}
+		if (object->depthDirty) {
+			object->depthDirty = false;
+			const double z = object->getZ();
+			if (z != keys[read]) {
+				movers.push_back(Mover{ z, std::move(object) });
+				continue;
+			}
+		}
+		if (write != read) {
+			objects[write] = std::move(object);
+			keys[write] = keys[read];
+		}
+		++write;
+	}
+	if (write == objects.size()) {
+		return;
+	}
+	objects.resize(write);
+	keys.resize(write);
+
+	for (auto& mover : movers) {
+		const auto index = std::upper_bound(keys.begin(), keys.end(), mover.z) - keys.begin();
+		keys.insert(keys.begin() + index, mover.z);
+		objects.insert(objects.begin() + index, std::move(mover.object));
+	}
+	movers.clear();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class SpineObject;
+
+/// Game objects sorted by SpineObject::getZ(). Instead of sorting every frame only objects whose
+/// position or layer changed since the last update() are moved to their new place. Objects with the
+/// same z keep the order in which they've been inserted.
+class DepthOrder {
+public:
+	using const_iterator = std::vector<std::shared_ptr<SpineObject>>::const_iterator;
+	using const_reverse_iterator = std::vector<std::shared_ptr<SpineObject>>::const_reverse_iterator;
+
+	void insert(std::shared_ptr<SpineObject>);
+	void clear();
+
+	/// Re-inserts all objects which have been marked with SpineObject::markDepthDirty(). If
+	/// dropRemoved is set, objects which have been erased from the ObjectStore are dropped.
+	void update(bool dropRemoved = false);
+
+	const_iterator begin() const { return objects.begin(); }
+	const_iterator end() const { return objects.end(); }
+	const_reverse_iterator rbegin() const { return objects.rbegin(); }
+	const_reverse_iterator rend() const { return objects.rend(); }
+	size_t size() const { return objects.size(); }
+	bool empty() const { return objects.empty(); }
+
+private:
+	std::vector<std::shared_ptr<SpineObject>> objects;
+	/// getZ() of objects at the time they've been (re-)inserted, always sorted
+	std::vector<double> keys;
+
+	struct Mover {
+		double z;
+		std::shared_ptr<SpineObject> object;
+	};
+	std::vector<Mover> movers;
+};
@@ -21,7 +21,7 @@ SpeechBubble::SpeechBubble(std::shared_ptr<Game> game,
 
 bool SpeechBubble::step(bool)
 {
-    skeleton->step();
+    stepSkeleton();
     return true;
 }
 
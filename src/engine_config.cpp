@@ -0,0 +1,18 @@
+#include "engine_config.hpp"
+
+EngineConfig EngineConfig::fromLua(const sol::table& config) {
+	EngineConfig result;
+	result.pointerMaxSpeed = config.get_or("pointer_max_speed", 0.f);
+	result.playerMaxSpeed = config.get_or("player_max_speed", 0.f);
+	result.gamepadSpeedMultiplier = config.get_or("gamepad_speed_multiplier", 0.f);
+	result.debugGrapDistance = config.get_or("debug_grap_distance", 0.f);
+	result.doubleClickTime = config.get_or("double_click_time", 0.0);
+	result.maxClickDistance = config.get_or("max_click_distance", 0.0);
+	result.playerWalkAnimation = config.get_or<std::string>("player_walk_animation", "");
+	result.playerIdleAnimation = config.get_or<std::string>("player_idle_animation", "");
+	result.playerBeamAnimation = config.get_or<std::string>("player_beam_animation", "");
+	result.pointerIdleAnimation = config.get_or<std::string>("pointer_idle_animation", "");
+	result.pointerOverAnimation = config.get_or<std::string>("pointer_over_animation", "");
+	result.spineDefaultAnimation = config.get_or<std::string>("spine_default_animation", "");
+	return result;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <sol/sol.hpp>
+
+#include <string>
+
+/// The values of the Lua table config that are read every step, copied into C++ types. Game
+/// rebuilds it when a script or savegame has assigned to a field of config (see
+/// Game::getEngineConfig()). Only top-level fields are copied, assignments to fields of nested
+/// tables like config.border.x wouldn't be noticed.
+struct EngineConfig {
+	float pointerMaxSpeed = 0;
+	float playerMaxSpeed = 0;
+	float gamepadSpeedMultiplier = 0;
+	/// Only set in debug builds
+	float debugGrapDistance = 0;
+	double doubleClickTime = 0;
+	double maxClickDistance = 0;
+
+	std::string playerWalkAnimation;
+	std::string playerIdleAnimation;
+	std::string playerBeamAnimation;
+	std::string pointerIdleAnimation;
+	std::string pointerOverAnimation;
+	std::string spineDefaultAnimation;
+
+	static EngineConfig fromLua(const sol::table& config);
+};
@@ -2,6 +2,10 @@
 
 #include "jngl/input.hpp"
 #include "shader_cache.hpp"
+#include "spine_data_cache.hpp"
+#include "render_queue.hpp"
+#include "job_pool.hpp"
+#include "profiler.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -41,6 +45,12 @@ Game::Game(const YAML::Node &config) : config(config),
     debug_info.setText(debug_text);
 
     debug_info.setPos(jngl::Vec2(-screensize.x / 2, -screensize.y / 2) + jngl::Vec2(5, 10));
+    render_stats.setFont(jngl::OutlinedFont(config["default_font"].as<std::string>(), 12, 9.f)
+                             .bake(0x000000ff_rgba, 0xccccccff_rgba));
+    render_stats.setPos(jngl::Vec2(-screensize.x / 2, screensize.y / 2) + jngl::Vec2(5, -45));
+#endif
+#ifdef ALPACA_PROFILER
+    Profiler::handle().setFont(config["default_font"].as<std::string>());
 #endif
 
 	bool language_supportet = false;
@@ -140,7 +150,7 @@ void Game::init(bool game_start)
 	configToLua();
 	setupLuaFunctions();
 	dialogManager = std::make_shared<DialogManager>(shared_from_this());
-	if (!game_start || config["auto_load_savegame"].as<bool>(true)) {
+	if (useSavegame && (!game_start || config["auto_load_savegame"].as<bool>(true))) {
 		loadLuaState();
 	} else {
 		loadLuaState(std::nullopt);
@@ -196,6 +206,41 @@ void Game::configToLua()
     (*lua_state)["config"]["border"]["x"] = config["border"]["x"].as<int>();
     (*lua_state)["config"]["border"]["y"] = config["border"]["y"].as<int>();
 	(*lua_state)["config"]["supportedLanguages"] = sol::as_table(config["supportedLanguages"].as<std::vector<std::string>>());
+	wrapConfig();
+}
+
+void Game::wrapConfig()
+{
+	const sol::table current = (*lua_state)["config"];
+	if (const sol::optional<sol::table> metatable = current[sol::metatable_key];
+	    metatable && (*metatable)["__backing"].valid())
+	{
+		return;
+	}
+	sol::protected_function makeProxy = lua_state->load(R"(
+		local backing, changed = ...
+		return setmetatable({}, {
+			__backing = backing,
+			__index = backing,
+			__newindex = function(_, key, value)
+				backing[key] = value
+				changed()
+			end,
+			__pairs = function() return next, backing, nil end,
+		})
+	)", "config proxy");
+	(*lua_state)["config"] = makeProxy(current, [this]() { engineConfigDirty = true; }).get<sol::table>();
+	engineConfigDirty = true;
+}
+
+const EngineConfig &Game::getEngineConfig()
+{
+	if (engineConfigDirty)
+	{
+		engineConfig = EngineConfig::fromLua((*lua_state)["config"]);
+		engineConfigDirty = false;
+	}
+	return engineConfig;
 }
 
 void Game::loadSceneWithFade(const std::string &level)
@@ -208,6 +253,7 @@ void Game::loadSceneWithFade(const std::string &level)
 		{
 			backgroundMusic = nextSceneJson["backgroundMusic"].as<std::string>();
 		}
+		scenePreloader = std::make_unique<ScenePreloader>(level, nextSceneJson, *lua_state);
 
 		jngl::setScene<SceneFade>(shared_from_this(), [this, level]() {
 			loadScene(level);
@@ -218,7 +264,7 @@ void Game::loadSceneWithFade(const std::string &level)
 #ifndef NDEBUG
 	// Run tests to get a savegame at the start of each scene
 	auto old_savegame = jngl::readConfig(level);
-	if(old_savegame.empty())
+	if(useSavegame && old_savegame.empty())
 	{
 		saveLuaState(level);
 	}
@@ -251,9 +297,17 @@ void Game::loadScene_internal()
 		std::advance(it, 1);
 	}
 	player = nullptr;
-	removeObjects();
+	updateObjectOrder();
+
+	std::unique_ptr<ScenePreloader> preloaded;
+	if (scenePreloader && scenePreloader->getSceneName() == nextScene)
+	{
+		preloaded = std::move(scenePreloader);
+		preloaded->wait();
+	}
+	scenePreloader.reset();
 
-	auto newScene = std::make_shared<Scene>(nextScene, shared_from_this());
+	auto newScene = std::make_shared<Scene>(nextScene, shared_from_this(), preloaded.get());
 	if (!newScene->background)
 	{
 		jngl::error("There is no scene with the name: " + nextScene);
@@ -261,7 +315,14 @@ void Game::loadScene_internal()
 	}
 
 	currentScene = newScene;
+	preloaded.reset();
+	SpineDataCache::handle().releaseUnused();
+	scriptCache.releaseUnused();
+	// Make the objects of the new scene visible, so that their obstacles are part of the nav mesh
+	updateObjectOrder();
+	animateObjects();
 	currentScene->background->step();
+	triangulateBorder();
 	currentScene->playMusic();
 
 	// Pointer should be last in gameObjects so it's on top
@@ -301,15 +362,21 @@ void Game::loadScene_internal()
 
 Game::~Game()
 {
-	saveLuaState();
+	if (useSavegame)
+	{
+		saveLuaState();
+	}
 	reset();
 }
 
 void Game::reset()
 {
 	gameObjects.clear();
-	needToAdd.clear();
-	needToRemove.clear();
+	objectIds.clear();
+	hitIndex.clear();
+	boundsQueue.clear();
+	pointerHit = std::nullopt;
+	scriptCache.clear();
 	lua_state = {};
 	currentScene = nullptr;
 	player = nullptr;
@@ -318,14 +385,23 @@ void Game::reset()
 
 void Game::step()
 {
+#ifdef ALPACA_PROFILER
+	Profiler::handle().beginFrame();
+	Profiler::handle().step();
+#endif
+	ALPACA_PROFILE_ZONE("Game::step");
+	// Before any skeleton is stepped, so that the overlay's awake/sleeping counts cover all of them
+	SkeletonDrawable::stepStats.reset();
 	if (!nextScene.empty())
 	{
 		loadScene_internal();
 	}
 
-	addObjects();
+	updateObjectOrder();
 	stepCamera();
+	animateObjects();
 
+	pointerHit = std::nullopt;
 	pointer->step();
 #ifndef NDEBUG
 	if (editMode) {
@@ -353,22 +429,24 @@ void Game::step()
 		std::advance(it, 1);
 	}
 
-	dialogManager->step();
+	{
+		ALPACA_PROFILE_ZONE("Dialog");
+		dialogManager->step();
+	}
     if (hotspot) {
         hotspot->step();
     }
 
-    // Sort game objects depending on each object's z value (layer):
-	sort(gameObjects.begin(), gameObjects.end(), [](const auto &lhs, const auto &rhs)
-		 { return lhs->getZ() < rhs->getZ(); });
-
 	enableHotspotHighlight = jngl::keyDown(jngl::key::Space) || jngl::mouseDown(jngl::mouse::Button::Right);
 #ifndef NDEBUG
 	debugStep();
 #endif
 	if(pointer)
 		pointer->resetHandledFlags();
-	removeObjects();
+
+	// Keep game objects sorted by each object's z value (layer), only moved objects are touched
+	updateObjectOrder();
+	syncLuaState();
 }
 
 #if (!defined(NDEBUG) && !defined(ANDROID) && (!defined(TARGET_OS_IOS) || TARGET_OS_IOS == 0) && !defined(__EMSCRIPTEN__))
@@ -394,6 +472,8 @@ void Game::debugStep()
     if (jngl::keyPressed("r") || reload) {
         std::this_thread::sleep_for(std::chrono::milliseconds(200));
 		ShaderCache::handle().clear();
+		SpineDataCache::handle().clear();
+		scriptCache.clear();
 		for (auto& obj : gameObjects) {
 			obj->setShader(obj->shader);
 		}
@@ -437,6 +517,11 @@ void Game::debugStep()
 		show_debug_info = !show_debug_info;
 	}
 
+	if (jngl::keyPressed("n"))
+	{
+		RenderQueue::handle().enabled = !RenderQueue::handle().enabled;
+	}
+
 	// Quick Save
 	if (jngl::keyPressed("c"))
 	{
@@ -615,6 +700,8 @@ void Game::debugStep()
 
 void Game::draw() const
 {
+	ALPACA_PROFILE_ZONE("Game::draw");
+	SkeletonDrawable::frameStats = {};
 	auto originalMv = jngl::modelview();
 	const jngl::FrameBuffer* fb1 = &frameBuffer1;
 	const jngl::FrameBuffer* fb2 = &frameBuffer2;
@@ -624,6 +711,8 @@ void Game::draw() const
 	applyCamera();
 	jngl::setColor(30, 200, 30, 255);
 
+	auto& renderQueue = RenderQueue::handle();
+	renderQueue.begin();
 	for (auto &obj : gameObjects)
 	{
 		if ((obj) == pointer)
@@ -631,10 +720,14 @@ void Game::draw() const
             continue;
         }
         if (const auto* shader = obj->getShaderProgram()) {
+            ALPACA_PROFILE_ZONE("Shader passes");
+            // Everything below this object has to be in fb1 before it's used as the shader's input
+            renderQueue.flush();
             auto disableBlending = jngl::disableBlending();
             {
                 auto _1 = jngl::drawOnlyIntoAlphaChannel();
                 obj->draw();
+                renderQueue.flush();
             }
             const auto passLocation = obj->getShaderTwoPassUniform();
             // E.g. two-pass separable blur: pass 0 = vertical, pass 1 = horizontal
@@ -657,6 +750,7 @@ void Game::draw() const
         }
         obj->draw();
     }
+    renderQueue.end();
     jngl::popMatrix();
 	context = std::nullopt;
 	fb1->draw(originalMv);
@@ -672,8 +766,23 @@ void Game::draw() const
 	{
 		jngl::setFontColor(0, 0, 0, 255);
 		debug_info.draw();
+
+		const auto& stats = SkeletonDrawable::frameStats;
+		const auto& steps = SkeletonDrawable::stepStats;
+		render_stats.setText(std::format("Spine: {} attachments in {} batches, {} vertex buffer allocations\n"
+		                                 "Skeletons: {} awake, {} sleeping, animated on {} threads\n"
+		                                 "Render queue ({}): {} commands in {} draw calls",
+		                                 stats.attachments, stats.batches, stats.allocations,
+		                                 steps.awake.load(), steps.sleeping.load(),
+		                                 JobPool::handle().getThreadCount(),
+		                                 renderQueue.enabled ? "on" : "off", renderQueue.stats.commands,
+		                                 renderQueue.stats.drawCalls));
+		render_stats.draw();
 	}
 #endif
+#ifdef ALPACA_PROFILER
+	Profiler::handle().draw();
+#endif
 
 	jngl::popMatrix();
 }
@@ -770,36 +879,107 @@ void Game::stepCamera()
 	cameraPosition += speed / 36.0;
 }
 
-void Game::add(const std::shared_ptr<SpineObject> &obj)
+void Game::animateObjects()
 {
-	needToAdd.emplace_back(obj);
+	ALPACA_PROFILE_ZONE("Spine update");
+	animated.clear();
+	for (auto it = gameObjects.rbegin(); it != gameObjects.rend(); ++it)
+	{
+		if (*it != pointer)
+		{
+			animated.push_back(*it);
+		}
+	}
+	JobPool::handle().parallelFor(animated.size(), [this](const size_t i) { animated[i]->animate(); });
+	// Lua must only run on the main thread and in the same order as the objects are stepped
+	for (const auto &obj : animated)
+	{
+		obj->afterAnimate();
+	}
+	animated.clear();
 }
 
-void Game::remove(const std::shared_ptr<SpineObject> &object)
+void Game::add(const std::shared_ptr<SpineObject> &obj)
 {
-	needToRemove.push_back(object);
+	objectIds[obj->getId()] = gameObjects.insert(obj);
 }
 
-void Game::addObjects()
+void Game::remove(const std::shared_ptr<SpineObject> &object)
 {
-	std::copy(needToAdd.begin(), needToAdd.end(), std::back_inserter(gameObjects));
-	needToAdd.clear();
+	// Objects without an id in the scene file share the name of their Spine project, the one added
+	// last is found
+	if (const auto it = objectIds.find(object->getId());
+	    it != objectIds.end() && it->second == object->getHandle())
+	{
+		objectIds.erase(it);
+	}
+	// E.g. when the scene changes, before the Lua state switches to the new one
+	object->syncLuaState();
+	hitIndex.erase(object->getHandle());
+	gameObjects.erase(object);
 }
 
-void Game::removeObjects()
+const Game::PointerHit &Game::getPointerHit()
 {
-	for (const auto &toRemove : needToRemove)
+	if (pointerHit)
+	{
+		return *pointerHit;
+	}
+	pointerHit.emplace();
+	if (!pointer)
+	{
+		return *pointerHit;
+	}
+	// Objects which only need their bounds for hit tests haven't updated them since they've moved
+	for (const auto &queued : boundsQueue)
 	{
-		for (auto it = gameObjects.begin(); it != gameObjects.end(); ++it)
+		if (auto obj = queued.lock())
 		{
-			if (*it == toRemove)
-			{
-				gameObjects.erase(it);
-				break;
-			}
+			obj->updateBounds();
+		}
+	}
+	boundsQueue.clear();
+	const jngl::Vec2 worldPosition = pointer->getWorldPosition();
+	const jngl::Vec2 screenPosition = pointer->getPosition();
+	hitCandidates.clear();
+	hitIndex.query(worldPosition, false, hitCandidates);
+	const size_t worldCandidates = hitCandidates.size();
+	hitIndex.query(screenPosition, true, hitCandidates);
+
+	// Only the few objects whose bounding box contains the pointer are tested against their polygons
+	for (size_t i = 0; i < hitCandidates.size(); ++i)
+	{
+		auto obj = gameObjects.get(hitCandidates[i]);
+		if (!obj || !obj->getVisible() || inactivLayerBorder > obj->getLayer() ||
+		    (pointerHit->object && obj->getZ() < pointerHit->object->getZ()))
+		{
+			continue;
+		}
+		const jngl::Vec2 position = i < worldCandidates ? worldPosition : screenPosition;
+		if (auto *box = obj->hitTest(position - obj->getPosition()))
+		{
+			pointerHit->object = std::move(obj);
+			pointerHit->box = box;
 		}
 	}
-	needToRemove.clear();
+	return *pointerHit;
+}
+
+void Game::updateObjectOrder()
+{
+	ALPACA_PROFILE_ZONE("Sort");
+	if (gameObjects.update())
+	{
+		obstaclesChanged();
+	}
+}
+
+void Game::triangulateBorder()
+{
+	if (currentScene && currentScene->background)
+	{
+		currentScene->background->updateNavMesh();
+	}
 }
 
 std::shared_ptr<DialogManager> Game::getDialogManager()
@@ -808,17 +988,17 @@ std::shared_ptr<DialogManager> Game::getDialogManager()
 }
 
 void Game::runAction(const std::string& actionName, std::shared_ptr<SpineObject> thisObject) {
+    ALPACA_PROFILE_ZONE("Lua");
     if (actionName.empty())
 	{
 		return;
 	}
 
-	std::string script;
 	lua_state->set("this", thisObject);
 
 	// if the name starts with "dlg:", play the dialog,
 	// no need for a separate Lua file
-	if (actionName.substr(0, 4) == "dlg:")
+	if (actionName.starts_with("dlg:"))
 	{
 		const std::string dialogName = actionName.substr(4);
 		sol::protected_function fn = (*lua_state)["PlayDialog"];
@@ -829,7 +1009,7 @@ void Game::runAction(const std::string& actionName, std::shared_ptr<SpineObject>
 		}
 		return;
 	}
-	else if (actionName.substr(0, 5) == "anim:")
+	else if (actionName.starts_with("anim:"))
 	{
 		const std::string animName = actionName.substr(5);
 		sol::protected_function fn = (*lua_state)["PlayAnimationOn"];
@@ -840,29 +1020,23 @@ void Game::runAction(const std::string& actionName, std::shared_ptr<SpineObject>
 		}
 		return;
 	}
-	// if there is no specific prefix, just load the according Lua file
+	// if there is no specific prefix, just run the according Lua file
 	else
 	{
-		const std::string file = "scripts/" + actionName + ".lua";
-		const std::stringstream scriptstream = jngl::readAsset(file);
-
-		if (!scriptstream)
-		{
-			jngl::error("Can not load lua script " + file);
-			return;
-		}
-		script = scriptstream.str();
-		jngl::log("lua", file);
-		auto result = lua_state->safe_script(script, sol::script_pass_on_error, "@" + file);
-		if (!result.valid()) {
-			const sol::error err = result;
-			jngl::error(err.what());
-		}
+		scriptCache.run(*lua_state, actionName);
 		return;
 	}
 }
 
+void Game::syncLuaState() {
+    ALPACA_PROFILE_ZONE("Lua");
+    for (const auto& obj : gameObjects) {
+        obj->syncLuaState();
+    }
+}
+
 void Game::saveLuaState(const std::string& savefile) {
+    syncLuaState();
     if (savefile.empty()) {
         return;
     }
@@ -891,6 +1065,7 @@ void Game::loadLuaState(const std::optional<std::string> &savefile)
 			jngl::error("Failed to load savgame {}\n{}", savefile.value(),
 					err.what());
 		}
+		wrapConfig(); // savegames written before config was a proxy replace it with a plain table
 	} else {
 		jngl::debug("Load lua state");
 	}
@@ -1013,10 +1188,20 @@ std::string Game::backupLuaTable(const sol::table table, const std::string &pare
 				result += parent + k + " = " + v + "\n";
 				break;
 			case sol::type::table:
+			{
+				const sol::table child = value.as<sol::table>();
+				// Proxies like config have to stay in place, their __newindex writes to the backing table
+				if (const sol::optional<sol::table> metatable = child[sol::metatable_key];
+				    metatable && (*metatable)["__backing"].valid())
+				{
+					result += backupLuaTable((*metatable)["__backing"], parent + k);
+					break;
+				}
 				result += parent + k + " = {}\n";
-				result += backupLuaTable(value.as<sol::table>(), parent + k);
+				result += backupLuaTable(child, parent + k);
 				break;
 			}
+			}
 		}
 	}
 
@@ -1027,38 +1212,24 @@ const std::shared_ptr<SpineObject> Game::getObjectById(const std::string &object
 {
 	if (objectId == "Player" || objectId == "player" || player->getName() == objectId)
 	{
-		return (*this->lua_state)["scenes"]["cross_scene"]["items"]["player"]["object"];
+		return player;
 	}
 	if (objectId == "Background")
 	{
 		return currentScene->background;
 	}
 
-	std::shared_ptr<SpineObject> obj = nullptr;
-	if ((*this->lua_state)[objectId].valid())
-	{
-		obj = (*this->lua_state)[objectId];
-	}
-	else if ((*this->lua_state)["inventory_items"][objectId].valid())
-	{
-		obj = (*this->lua_state)["inventory_items"][objectId]["object"];
-	}
-	else
+	// Scene items, inventory items and cross scene items are all in gameObjects
+	if (const auto it = objectIds.find(objectId); it != objectIds.end())
 	{
-		std::string scene = (*this->lua_state)["game"]["scene"];
-		if ((*this->lua_state)["scenes"][scene]["items"][objectId].valid())
-		{
-			obj = (*this->lua_state)["scenes"][scene]["items"][objectId]["object"];
-		}
+		return gameObjects.get(it->second);
 	}
-	if (obj == nullptr)
+	// Objects stored in Lua globals, e.g. this
+	if (const sol::optional<std::shared_ptr<SpineObject>> obj = (*this->lua_state)[objectId])
 	{
-		if ((*this->lua_state)["scenes"]["cross_scene"]["items"][objectId].valid())
-		{
-			obj = (*this->lua_state)["scenes"]["cross_scene"]["items"][objectId]["object"];
-		}
+		return *obj;
 	}
-	return obj;
+	return nullptr;
 }
 
 sol::table_proxy<sol::table, std::tuple<std::string>> Game::getObjectTable(const std::string& objectId) {
@@ -1095,13 +1266,9 @@ void Game::onFileDrop(const std::filesystem::path& path)
 {
 	std::string spine_file = path.stem().string();
 
-    auto atlas = std::make_unique<spine::Atlas>((spine_file + "/" + spine_file + ".atlas").c_str(), &SkeletonDrawable::textureLoader);
-    assert(atlas);
-    auto json = std::make_unique<spine::SkeletonJson>(*atlas);
-    std::unique_ptr<spine::SkeletonData> skeletonData;
-	skeletonData.reset((json->readSkeletonDataFile((spine_file + "/" + spine_file + ".json").c_str())));
+    const auto spineData = SpineDataCache::handle().get(spine_file);
 
-    if (!skeletonData) {
+    if (!spineData) {
         jngl::error("Error loading " + spine_file + " Spine project. Make sure it is saved in data-src and prepare_assets is running.");
 		return;
     }
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <jngl.hpp>
+#include <unordered_map>
 #include <vector>
 #include <sol/sol.hpp>
 #include "player.hpp"
@@ -10,6 +11,11 @@
 #include "scene.hpp"
 #include "dialog/dialog_manager.hpp"
 #include "audio_manager.hpp"
+#include "scene_preloader.hpp"
+#include "object_store.hpp"
+#include "hit_index.hpp"
+#include "engine_config.hpp"
+#include "script_cache.hpp"
 
 class Game : public jngl::Work, public std::enable_shared_from_this<Game>
 {
@@ -21,8 +27,18 @@ public:
     void loadSceneWithFade(const std::string &level);
     void setupLuaFunctions();
     void configToLua();
+    /// Typed copy of the Lua table config, rebuilt on the first call after Lua assigned to config
+    const EngineConfig &getEngineConfig();
+    /// Compiled action scripts and prepared Spine events
+    ScriptCache &getScriptCache() { return scriptCache; }
+    /// Writes the fields objects have marked dirty into their Lua tables (see
+    /// SpineObject::syncLuaState()), once per step and before saving
+    void syncLuaState();
+    /// Calls syncLuaState() first
     void saveLuaState(const std::string &savefile = "savegame");
     void loadLuaState(const std::optional<std::string> &savefile = "savegame");
+    /// Serializes table as Lua assignments to parent, used for savegames
+    std::string backupLuaTable(const sol::table table, const std::string &parent);
 
     void runAction(const std::string &actionName, std::shared_ptr<SpineObject> thisObject);
 
@@ -43,6 +59,8 @@ public:
                         const uint8_t* pixels);
 
     jngl::Text debug_info;
+    /// Render statistics of the last frame, shown below debug_info
+    mutable jngl::Text render_stats;
     std::string debug_text = ("Press Tab to enter editmode. \n"
 		"Press F10 to show debug draw. \n"
 #ifdef JNGL_RECORD
@@ -57,6 +75,7 @@ public:
 		"Press s in editmode to save changes to a scene. \n"
 		"Press m to mute and unmute audio. \n"
 		"Press z to toggle zBufferMap. \n"
+		"Press n to toggle render batching. \n"
 		"Press x to hide this text.");
 #endif
 
@@ -72,6 +91,9 @@ public:
     void setCameraPositionImmediately(jngl::Vec2);
 
     void stepCamera();
+    /// Animates all objects on the JobPool, then dispatches their Spine events in step order
+    void animateObjects();
+    /// Builds the nav mesh of the current scene now instead of on the first path query
     void triangulateBorder();
 
     void add(const std::shared_ptr<SpineObject> &obj);
@@ -84,8 +106,8 @@ public:
     std::shared_ptr<Hotspot> hotspot = nullptr;
 
     std::shared_ptr<DialogManager> getDialogManager();
-    void addObjects();
-    void removeObjects();
+    /// Inserts added objects, drops removed ones and re-sorts moved ones (see ObjectStore::update())
+    void updateObjectOrder();
 
     std::shared_ptr<Scene> currentScene = nullptr;
     std::string nextScene;
@@ -101,22 +123,66 @@ public:
     sol::table_proxy<sol::table, std::tuple<std::string>> getObjectTable(const std::string& objectId);
 
     const std::string cleanLuaString(std::string variable);
-    std::vector<std::shared_ptr<SpineObject>> gameObjects;
+
+    /// Increased whenever an object's SpineObject::getObstacles() changed or objects have been
+    /// added or removed
+    uint32_t getObstacleRevision() const { return obstacleRevision; }
+    void obstaclesChanged() { ++obstacleRevision; }
+
+    /// Sorted by z, drawn from front to back and stepped in reverse
+    ObjectStore gameObjects;
+    /// Bounding boxes of gameObjects, kept up to date by SpineObject::updateBounds()
+    HitIndex hitIndex;
+
+    struct PointerHit
+    {
+        /// Topmost visible object of an active layer under the pointer, nullptr if there's none
+        std::shared_ptr<SpineObject> object;
+        /// The bounding box of object the pointer is over
+        spine::BoundingBoxAttachment *box = nullptr;
+    };
+    /// What's under the pointer in this frame. Computed on the first call after the pointer has
+    /// moved, so that the pointer, the objects and the background share one hit test per frame.
+    const PointerHit &getPointerHit();
+    /// Called by SpineObject::markBoundsDirty(), getPointerHit() updates the object's bounds
+    void boundsChanged(std::weak_ptr<SpineObject> obj) { boundsQueue.emplace_back(std::move(obj)); }
     bool enable_fade = true;
+    /// false for --benchmark: init() starts from a fresh Lua state and the savegame on disk is
+    /// never written, so that runs are reproducible and don't touch the player's progress
+    bool useSavegame = true;
 
 private:
     YAML::Node config;
     void loadScene(const std::string& level);
     void loadScene_internal();
 
-    std::vector<std::shared_ptr<SpineObject>> needToAdd;
-    std::vector<std::shared_ptr<SpineObject>> needToRemove;
-    std::string backupLuaTable(const sol::table table, const std::string &parent);
+    /// Assets of the scene SceneFade is fading to, loaded in the background
+    std::unique_ptr<ScenePreloader> scenePreloader;
+
+    /// Replaces the global config with an empty proxy whose __newindex writes to the table that
+    /// was there before, stored in the metatable as __backing, and marks engineConfig as outdated.
+    /// Nested tables aren't wrapped, so EngineConfig only copies top-level fields. The proxy itself
+    /// is empty: pairs(config) goes through __pairs, but next(config) and raw iteration from C++
+    /// (e.g. sol::table::for_each) see an empty table and have to use __backing instead.
+    void wrapConfig();
+    EngineConfig engineConfig;
+    bool engineConfigDirty = true;
+    /// Declared after lua_state, so that it's destroyed first
+    ScriptCache scriptCache;
+
     jngl::Vec2 cameraPosition;
     jngl::Vec2 targetCameraPosition;
     jngl::Vec2 cameraDeadzone;
     double cameraZoom = 1.0;
     int inactivLayerBorder = 0;
+    uint32_t obstacleRevision = 0;
+    std::optional<PointerHit> pointerHit;
+    std::vector<ObjectHandle> hitCandidates;
+    std::vector<std::weak_ptr<SpineObject>> boundsQueue;
+    std::vector<std::shared_ptr<SpineObject>> animated;
+    /// SpineObject::getId() of everything in gameObjects, maintained by add() and remove(). The
+    /// items tables in Lua only mirror the handles for savegames.
+    std::unordered_map<std::string, ObjectHandle> objectIds;
     std::shared_ptr<DialogManager> dialogManager = nullptr;
     jngl::FrameBuffer frameBuffer1{jngl::getWindowSize()};
     jngl::FrameBuffer frameBuffer2{jngl::getWindowSize()};
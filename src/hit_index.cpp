@@ -0,0 +1,120 @@
+#include "hit_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+void removeIndex(std::vector<uint32_t>& indices, const uint32_t index) {
+	const auto it = std::find(indices.begin(), indices.end(), index);
+	if (it != indices.end()) {
+		*it = indices.back();
+		indices.pop_back();
+	}
+}
+
+} // namespace
+
+int HitIndex::cell(const float coordinate) {
+	return static_cast<int>(std::floor(coordinate / CELL_SIZE));
+}
+
+uint64_t HitIndex::key(const int x, const int y) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void HitIndex::update(const ObjectHandle handle, const Box box, const bool screenSpace) {
+	if (!handle) {
+		return;
+	}
+	if (handle.index >= entries.size()) {
+		entries.resize(handle.index + 1);
+	}
+	auto& entry = entries[handle.index];
+	const int minX = cell(box.minX);
+	const int minY = cell(box.minY);
+	const int maxX = cell(box.maxX);
+	const int maxY = cell(box.maxY);
+	if (entry.generation == handle.generation && entry.screenSpace == screenSpace &&
+	    entry.minX == minX && entry.minY == minY && entry.maxX == maxX && entry.maxY == maxY) {
+		entry.box = box; // Still covers the same cells
+		return;
+	}
+	unlink(handle.index);
+	entry.generation = handle.generation;
+	entry.box = box;
+	entry.screenSpace = screenSpace;
+	entry.minX = minX;
+	entry.minY = minY;
+	entry.maxX = maxX;
+	entry.maxY = maxY;
+	link(handle.index);
+}
+
+void HitIndex::erase(const ObjectHandle handle) {
+	if (handle && handle.index < entries.size() &&
+	    entries[handle.index].generation == handle.generation) {
+		unlink(handle.index);
+	}
+}
+
+void HitIndex::clear() {
+	entries.clear();
+	for (auto& grid : grids) {
+		grid.cells.clear();
+		grid.large.clear();
+	}
+}
+
+void HitIndex::query(const jngl::Vec2 point, const bool screenSpace,
+                     std::vector<ObjectHandle>& result) const {
+	const auto x = static_cast<float>(point.x);
+	const auto y = static_cast<float>(point.y);
+	const auto test = [&](const uint32_t index) {
+		const auto& entry = entries[index];
+		if (entry.box.minX <= x && x <= entry.box.maxX && entry.box.minY <= y &&
+		    y <= entry.box.maxY) {
+			result.push_back(ObjectHandle{ index, entry.generation });
+		}
+	};
+	const auto& grid = grids[screenSpace ? 1 : 0];
+	if (const auto it = grid.cells.find(key(cell(x), cell(y))); it != grid.cells.end()) {
+		std::for_each(it->second.begin(), it->second.end(), test);
+	}
+	std::for_each(grid.large.begin(), grid.large.end(), test);
+}
+
+void HitIndex::link(const uint32_t index) {
+	auto& entry = entries[index];
+	auto& grid = grids[entry.screenSpace ? 1 : 0];
+	entry.large = static_cast<int64_t>(entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1) >
+	              MAX_CELLS;
+	if (entry.large) {
+		grid.large.push_back(index);
+		return;
+	}
+	for (int x = entry.minX; x <= entry.maxX; ++x) {
+		for (int y = entry.minY; y <= entry.maxY; ++y) {
+			grid.cells[key(x, y)].push_back(index);
+		}
+	}
+}
+
+void HitIndex::unlink(const uint32_t index) {
+	auto& entry = entries[index];
+	if (entry.generation == 0) {
+		return;
+	}
+	auto& grid = grids[entry.screenSpace ? 1 : 0];
+	if (entry.large) {
+		removeIndex(grid.large, index);
+	} else {
+		for (int x = entry.minX; x <= entry.maxX; ++x) {
+			for (int y = entry.minY; y <= entry.maxY; ++y) {
+				// Empty cells are kept, objects are likely to move back into them
+				removeIndex(grid.cells[key(x, y)], index);
+			}
+		}
+	}
+	entry.generation = 0;
+}
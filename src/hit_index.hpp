@@ -0,0 +1,52 @@
+#pragma once
+
+#include "object_store.hpp"
+
+#include <jngl/Vec2.hpp>
+#include <unordered_map>
+#include <vector>
+
+/// Uniform grid over the bounding boxes of the game objects, so that finding the objects under the
+/// pointer only has to look at the objects near it. Objects positioned in screen coordinates
+/// (SpineObject::abs_position) are kept in a grid of their own.
+class HitIndex {
+public:
+	struct Box {
+		float minX, minY, maxX, maxY;
+		bool operator==(const Box&) const = default;
+	};
+
+	/// Inserts the object or moves it to the cells covered by box
+	void update(ObjectHandle, Box, bool screenSpace);
+	void erase(ObjectHandle);
+	void clear();
+
+	/// Appends the handles of all objects whose box contains point. Handles of objects which have
+	/// been removed from the ObjectStore without being erased here can be part of the result.
+	void query(jngl::Vec2 point, bool screenSpace, std::vector<ObjectHandle>& result) const;
+
+private:
+	static constexpr float CELL_SIZE = 256;
+	/// Objects covering more cells than this are kept in Grid::large and tested for every query
+	static constexpr int MAX_CELLS = 256;
+
+	struct Entry {
+		uint32_t generation = 0; // 0 = not linked into any grid
+		Box box;
+		bool screenSpace = false;
+		bool large = false;
+		int minX = 0, minY = 0, maxX = 0, maxY = 0; // covered cells
+	};
+	struct Grid {
+		std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+		std::vector<uint32_t> large;
+	};
+
+	static int cell(float);
+	static uint64_t key(int x, int y);
+	void link(uint32_t index);
+	void unlink(uint32_t index);
+
+	std::vector<Entry> entries;
+	Grid grids[2];
+};
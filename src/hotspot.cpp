@@ -10,7 +10,7 @@ Hotspot::Hotspot(std::shared_ptr<Game> game, const std::string& spine_file)
 }
 
 bool Hotspot::step(bool) {
-    skeleton->step();
+    stepSkeleton();
 
     return false;
 }
@@ -3,6 +3,7 @@
 #include "jngl/Mat3.hpp"
 #include "skeleton_drawable.hpp"
 #include "game.hpp"
+#include "render_queue.hpp"
 
 #include <cmath>
 
@@ -14,13 +15,10 @@ bool InteractableObject::step(bool force)
 {
     if (auto _game = game.lock())
     {
-        skeleton->step();
-        bounds->update(*skeleton->skeleton, true);
-
 #ifndef NDEBUG
         if (_game->editMode  && !abs_position)
         {
-            const float DEBUG_GRAP_DISTANCE = (*_game->lua_state)["config"]["debug_grap_distance"];
+            const float DEBUG_GRAP_DISTANCE = _game->getEngineConfig().debugGrapDistance;
             mouseOver = false;
             for (auto cursor : jngl::input().cursors()) {
                 mouseOver = std::sqrt((cursor.pos().x - position.x) * (cursor.pos().x - position.x) +
@@ -33,7 +31,7 @@ bool InteractableObject::step(bool force)
             }
         }
         if (mouseDown) {
-            position = mouseDown->newPos();
+            setPosition(mouseDown->newPos());
             jngl::debug("{} \"{}\"", position, luaIndex);
             _game->currentScene->updateObjectPosition(id, position);
             if (mouseDown->released()) {
@@ -60,27 +58,19 @@ bool InteractableObject::step(bool force)
         // TODO Double Click on Objekts
         if (_game->pointer->primaryPressed() && visible && !_game->pointer->isPrimaryAlreadyHandled())
         {
-            jngl::Vec2 click_position = _game->pointer->getWorldPosition();
-            if (abs_position)
+            const auto &hit = _game->getPointerHit();
+            if (hit.object.get() == this)
             {
-                click_position = _game->pointer->getPosition();
-            }
-
-            auto *collision = bounds->containsPoint(static_cast<float>(click_position.x) - static_cast<float>(position.x), static_cast<float>(click_position.y) - static_cast<float>(position.y));
-            if (collision)
-            {
-                collision_script = collision->getName().buffer();
-                if (collision_script != "non_walkable_area") {
-                    jngl::debug("clicked interactable item {}", collision_script);
-                    _game->pointer->setPrimaryHandled();
-                    _game->runAction(collision_script, getptr());
-                }
+                collision_script = hit.box->getName().buffer();
+                jngl::debug("clicked interactable item {}", collision_script);
+                _game->pointer->setPrimaryHandled();
+                _game->runAction(collision_script, getptr());
             }
         }
 
         if (parent)
         {
-            position = parent->getPosition();
+            setPosition(parent->getPosition());
         }
     }
 
@@ -136,6 +126,7 @@ void InteractableObject::draw() const
                     {
                         _game->hotspot->draw(pos);
                     }else{
+                        RenderQueue::handle().flush();
                         jngl::drawCircle(pos, 5);
                     }
                 }
@@ -148,7 +139,8 @@ void InteractableObject::draw() const
     {
         if (_game->editMode && !abs_position)
         {
-            const float DEBUG_GRAP_DISTANCE = (*_game->lua_state)["config"]["debug_grap_distance"];
+            RenderQueue::handle().flush();
+            const float DEBUG_GRAP_DISTANCE = _game->getEngineConfig().debugGrapDistance;
             jngl::drawCircle(mv, DEBUG_GRAP_DISTANCE,
                              jngl::Rgba(0, mouseOver ? 0.7 : (mouseDown ? 0.4 : 0.9), 0, 0.9));
             jngl::Text pposition;
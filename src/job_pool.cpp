@@ -0,0 +1,132 @@
+#include "job_pool.hpp"
+
+#include <algorithm>
+
+JobPool::JobPool() {
+#ifndef __EMSCRIPTEN__
+	// The main thread works too
+	const size_t workerCount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+#else
+	const size_t workerCount = 0;
+#endif
+	for (size_t i = 0; i <= workerCount; ++i) {
+		queues.emplace_back(std::make_unique<Queue>());
+	}
+	for (size_t i = 0; i < workerCount; ++i) {
+		workers.emplace_back([this, i]() { run(i); });
+	}
+}
+
+JobPool::~JobPool() {
+	{
+		const std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+size_t JobPool::getThreadCount() const {
+	return queues.size();
+}
+
+void JobPool::parallelFor(const size_t count, const std::function<void(size_t)>& fn) {
+	if (workers.empty() || count < 2) {
+		for (size_t i = 0; i < count; ++i) {
+			fn(i);
+		}
+		return;
+	}
+
+	// Several ranges per thread, so that threads which got cheap objects can steal from the others
+	const size_t chunk = std::max<size_t>(1, count / (queues.size() * 4));
+	job = &fn;
+	exception = nullptr;
+	remaining = count;
+	size_t queueIndex = 0;
+	for (size_t begin = 0; begin < count; begin += chunk) {
+		auto& queue = *queues[queueIndex];
+		{
+			const std::lock_guard lock(queue.mutex);
+			queue.ranges.push_back(Range{ begin, std::min(begin + chunk, count) });
+		}
+		queueIndex = (queueIndex + 1) % queues.size();
+	}
+	{
+		const std::lock_guard lock(mutex);
+		++generation;
+	}
+	wakeUp.notify_all();
+
+	work(queues.size() - 1);
+	{
+		std::unique_lock lock(mutex);
+		done.wait(lock, [this]() { return remaining == 0; });
+	}
+	job = nullptr;
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+
+void JobPool::run(const size_t workerIndex) {
+	uint64_t lastGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock lock(mutex);
+			wakeUp.wait(lock, [&]() { return stopping || generation != lastGeneration; });
+			if (stopping) {
+				return;
+			}
+			lastGeneration = generation;
+		}
+		work(workerIndex);
+	}
+}
+
+void JobPool::work(const size_t self) {
+	Range range{};
+	while (pop(self, range) || steal(self, range)) {
+		for (size_t i = range.begin; i < range.end; ++i) {
+			try {
+				(*job)(i);
+			} catch (...) {
+				const std::lock_guard lock(exceptionMutex);
+				if (!exception) {
+					exception = std::current_exception();
+				}
+			}
+		}
+		const size_t size = range.end - range.begin;
+		if (remaining.fetch_sub(size) == size) {
+			const std::lock_guard lock(mutex); // so that the notification can't get lost
+			done.notify_one();
+		}
+	}
+}
+
+bool JobPool::pop(const size_t self, Range& range) {
+	auto& queue = *queues[self];
+	const std::lock_guard lock(queue.mutex);
+	if (queue.ranges.empty()) {
+		return false;
+	}
+	range = queue.ranges.front();
+	queue.ranges.pop_front();
+	return true;
+}
+
+bool JobPool::steal(const size_t self, Range& range) {
+	for (size_t i = 1; i < queues.size(); ++i) {
+		auto& queue = *queues[(self + i) % queues.size()];
+		const std::lock_guard lock(queue.mutex);
+		if (!queue.ranges.empty()) {
+			range = queue.ranges.back();
+			queue.ranges.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <jngl.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Worker threads for data parallel loops over the game objects. Each thread owns a queue of index
+/// ranges and takes them from the front, threads which run out of work steal from the back of the
+/// others. On Emscripten there are no workers and everything runs on the calling thread.
+class JobPool : public jngl::Singleton<JobPool> {
+public:
+	JobPool();
+	~JobPool();
+
+	/// Calls fn(i) for every i in [0, count) and returns when all calls are done. The calling thread
+	/// helps, so this must not be called from fn itself. The first exception thrown by fn is
+	/// rethrown here.
+	void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+	/// Number of threads parallelFor uses, including the calling one
+	size_t getThreadCount() const;
+
+private:
+	struct Range {
+		size_t begin;
+		size_t end;
+	};
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Range> ranges;
+	};
+
+	void run(size_t workerIndex);
+	/// Executes ranges from queue self and from the others until there's nothing left
+	void work(size_t self);
+	bool pop(size_t self, Range&);
+	bool steal(size_t self, Range&);
+
+	std::vector<std::thread> workers;
+	/// One per worker, the last one belongs to the thread calling parallelFor
+	std::vector<std::unique_ptr<Queue>> queues;
+
+	const std::function<void(size_t)>* job = nullptr;
+	std::atomic<size_t> remaining = 0;
+	std::exception_ptr exception;
+	std::mutex exceptionMutex;
+
+	std::mutex mutex;
+	/// Wakes the workers when there's a new job or they should stop
+	std::condition_variable wakeUp;
+	/// Wakes the calling thread when remaining dropped to 0
+	std::condition_variable done;
+	uint64_t generation = 0;
+	bool stopping = false;
+};
@@ -78,11 +78,7 @@ void Game::setupLuaFunctions()
 							{
 								const std::shared_ptr<SpineObject> obj = (*lua_state)["this"];
 								obj->playAnimation(trackIndex, newAnimation, loop, std::move(callback));
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["animation"] = newAnimation;
-									lua_object["loop_animation"] = loop;
-								}
+								obj->setLuaAnimation(newAnimation, loop);
 							});
 
 	/// Adds an animation to the calling Spine object that will be played after the current animation ends.
@@ -95,11 +91,7 @@ void Game::setupLuaFunctions()
 							{
 								const std::shared_ptr<SpineObject> obj = (*lua_state)["this"];
 								obj->addAnimation(trackIndex, newAnimation, loop, delay, std::move(callback));
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["animation"] = newAnimation;
-									lua_object["loop_animation"] = loop;
-								}
+								obj->setLuaAnimation(newAnimation, loop);
 							});
 
 	/// See PlayAnimation
@@ -115,11 +107,7 @@ void Game::setupLuaFunctions()
 								if (obj)
 								{
 									obj->playAnimation(trackIndex, newAnimation, loop, std::move(callback));
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["animation"] = newAnimation;
-										lua_object["loop_animation"] = loop;
-									}
+									obj->setLuaAnimation(newAnimation, loop);
 								}
 							});
 
@@ -136,11 +124,7 @@ void Game::setupLuaFunctions()
 								if (obj)
 								{
 									obj->addAnimation(trackIndex, newAnimation, loop, delay, std::move(callback));
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["animation"] = newAnimation;
-										lua_object["loop_animation"] = loop;
-									}
+									obj->setLuaAnimation(newAnimation, loop);
 								}
 							});
 
@@ -151,11 +135,7 @@ void Game::setupLuaFunctions()
 							{
 								const std::shared_ptr<SpineObject> obj = (*lua_state)["this"];
 								obj->setSkin(skin);
-								const std::vector<LuaSpineSkin> skins = {skin};
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["skin"] = sol::as_table(skins);
-								}
+								obj->markLuaDirty(SpineObject::LuaSkin);
 							});
 
 	/// See SetSkin
@@ -168,11 +148,7 @@ void Game::setupLuaFunctions()
 								if (obj)
 								{
 									obj->setSkin(skin);
-									const std::vector<LuaSpineSkin> skins = {skin};
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["skin"] = sol::as_table(skins);
-									}
+									obj->markLuaDirty(SpineObject::LuaSkin);
 								}
 							});
 
@@ -184,10 +160,7 @@ void Game::setupLuaFunctions()
 							{
 								const std::shared_ptr<SpineObject> obj = (*lua_state)["this"];
 								obj->setSkins(skins);
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["skin"] = sol::as_table(skins);
-								}
+								obj->markLuaDirty(SpineObject::LuaSkin);
 							});
 
 	/// See SetSkins
@@ -200,10 +173,7 @@ void Game::setupLuaFunctions()
 								if (obj)
 								{
 									obj->setSkins(skins);
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["skin"] = sol::as_table(skins);
-									}
+									obj->markLuaDirty(SpineObject::LuaSkin);
 								}
 							});
 
@@ -222,21 +192,7 @@ void Game::setupLuaFunctions()
     lua_state->set_function("RunScript",
                             [this](const LuaScript& scriptName)
 	{
-		const std::string file = "scripts/" + scriptName + ".lua";
-		const std::stringstream scriptstream = jngl::readAsset(file);
-
-		if (!scriptstream)
-		{
-			jngl::error("Can not load lua script " + file);
-			return;
-		}
-		auto script = scriptstream.str();
-		jngl::log("lua", file);
-		auto result = lua_state->safe_script(script, sol::script_pass_on_error, "@" + file);
-		if (!result.valid()) {
-			const sol::error err = result;
-			jngl::error(err.what());
-		}
+		scriptCache.run(*lua_state, scriptName);
     });
 
 	/// Add the current item to the inventory.
@@ -258,11 +214,7 @@ void Game::setupLuaFunctions()
 								(*lua_state)["inventory_items"][obj->getId()] = item;
 								(*lua_state)["inventory_items"][obj->getId()]["cross_scene"] = true;
 
-								const std::vector<LuaSpineSkin> skins = {(*lua_state)["config"]["inventory_default_skin"]};
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["skin"] = sol::as_table(skins);
-								}
+								obj->markLuaDirty(SpineObject::LuaSkin);
 
 								(*lua_state)["scenes"][(*lua_state)["game"]["scene"]]["items"][obj->getId()] = sol::lua_nil;
 							});
@@ -279,14 +231,12 @@ void Game::setupLuaFunctions()
 									return;
 								}
 
-								const std::vector<LuaSpineSkin> skins = {skin};
-
 								obj->setSkin(skin);
 								obj->setCrossScene(true);
 								obj->setVisible(false);
 								(*lua_state)["inventory_items"][obj->getId()] = item;
-								(*lua_state)["inventory_items"][obj->getId()]["skin"] = sol::as_table(skins);
 								(*lua_state)["inventory_items"][obj->getId()]["cross_scene"] = true;
+								obj->markLuaDirty(SpineObject::LuaSkin);
 
 								(*lua_state)["scenes"][(*lua_state)["game"]["scene"]]["items"][obj->getId()] = sol::lua_nil;
 							});
@@ -309,10 +259,9 @@ void Game::setupLuaFunctions()
 									obj->setSkin((*lua_state)["config"]["inventory_default_skin"]);
 									obj->setCrossScene(true);
 									obj->setVisible(false);
-									const std::vector<LuaSpineSkin> skins = {(*lua_state)["config"]["inventory_default_skin"]};
 									(*lua_state)["inventory_items"][obj->getId()] = item;
-									(*lua_state)["inventory_items"][obj->getId()]["skin"] = sol::as_table(skins);
 									(*lua_state)["inventory_items"][obj->getId()]["cross_scene"] = true;
+									obj->markLuaDirty(SpineObject::LuaSkin);
 
 									(*lua_state)["scenes"][(*lua_state)["game"]["scene"]]["items"][obj->getId()] = sol::lua_nil;
 								}
@@ -334,14 +283,12 @@ void Game::setupLuaFunctions()
 										return;
 									}
 
-									const std::vector<LuaSpineSkin> skins = {skin};
-
 									obj->setSkin(skin);
 									obj->setCrossScene(true);
 									obj->setVisible(false);
 									(*lua_state)["inventory_items"][obj->getId()] = item;
-									(*lua_state)["inventory_items"][obj->getId()]["skin"] = sol::as_table(skins);
 									(*lua_state)["inventory_items"][obj->getId()]["cross_scene"] = true;
+									obj->markLuaDirty(SpineObject::LuaSkin);
 
 									(*lua_state)["scenes"][(*lua_state)["game"]["scene"]]["items"][obj->getId()] = sol::lua_nil;
 								}
@@ -535,11 +482,7 @@ void Game::setupLuaFunctions()
 										point->addTargetPositionImmediately(position.value(), std::nullopt);
 									}
 									obj->setPosition(position.value());
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["x"] = position->x;
-										lua_object["y"] = position->y;
-									}
+									obj->setLuaPosition(obj->getPosition());
 								}
 								else {
 									jngl::error("No point called " + point_name);
@@ -566,11 +509,7 @@ void Game::setupLuaFunctions()
                                             player->addTargetPositionImmediately(position.value(), std::nullopt);
                                         }
                                         obj->setPosition(position.value());
-                                        sol::table lua_object = getObjectTable(obj->getId());
-                                        if (lua_object.valid()) {
-                                            lua_object["x"] = position->x;
-                                            lua_object["y"] = position->y;
-                                        }
+                                        obj->setLuaPosition(obj->getPosition());
 									}else {
 										jngl::error("No point called " + point_name);
 									}
@@ -597,11 +536,7 @@ void Game::setupLuaFunctions()
 									if (obj && position)
 									{
 										obj->setPosition(frm->getPosition() + position.value());
-										sol::table lua_object = getObjectTable(obj->getId());
-										if (lua_object.valid()) {
-											lua_object["x"] = frm->getPosition().x + position->x;
-											lua_object["y"] = frm->getPosition().y + position->y;
-										}
+										obj->setLuaPosition(obj->getPosition());
 									}else {
 										jngl::error("No point called " + point_name + "on " + obj->getName());
 									}
@@ -614,10 +549,7 @@ void Game::setupLuaFunctions()
 							{
 								const std::shared_ptr<SpineObject> obj = (*lua_state)["this"];
 								obj->setVisible(false);
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["visible"] = false;
-								}
+								obj->markLuaDirty(SpineObject::LuaVisible);
 							});
 
 	/// See SetHidden
@@ -629,10 +561,7 @@ void Game::setupLuaFunctions()
 								if (obj)
 								{
 									obj->setVisible(false);
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["visible"] = false;
-									}
+									obj->markLuaDirty(SpineObject::LuaVisible);
 								}
 							});
 
@@ -642,10 +571,7 @@ void Game::setupLuaFunctions()
 							{
 								const std::shared_ptr<SpineObject> obj = (*lua_state)["this"];
 								obj->setVisible(true);
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["visible"] = true;
-								}
+								obj->markLuaDirty(SpineObject::LuaVisible);
 							});
 
 	/// See SetVisible
@@ -657,10 +583,7 @@ void Game::setupLuaFunctions()
 								if (obj)
 								{
 									obj->setVisible(true);
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["visible"] = true;
-									}
+									obj->markLuaDirty(SpineObject::LuaVisible);
 								}
 							});
 
@@ -671,11 +594,8 @@ void Game::setupLuaFunctions()
 							[this](int layer)
 							{
 								const std::shared_ptr<SpineObject> obj = (*lua_state)["this"];
-								obj->layer = layer;
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["layer"] = layer;
-								}
+								obj->setLayer(layer);
+								obj->markLuaDirty(SpineObject::LuaLayer);
 							});
 
 	/// See SetLayer
@@ -686,11 +606,8 @@ void Game::setupLuaFunctions()
 								const std::shared_ptr<SpineObject> obj = getObjectById(object);
 								if (obj)
 								{
-									obj->layer = layer;
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["layer"] = layer;
-									}
+									obj->setLayer(layer);
+									obj->markLuaDirty(SpineObject::LuaLayer);
 								}
 							});
 
@@ -830,10 +747,7 @@ void Game::setupLuaFunctions()
 							{
 								const std::shared_ptr<SpineObject> obj = (*lua_state)["this"];
 								obj->setScale(scale);
-								sol::table lua_object = getObjectTable(obj->getId());
-								if (lua_object.valid()) {
-									lua_object["scale"] = std::to_string(scale);
-								}
+								obj->markLuaDirty(SpineObject::LuaScale);
 							});
 
 	/// See SetScale
@@ -846,10 +760,7 @@ void Game::setupLuaFunctions()
 								if (obj)
 								{
 									obj->setScale(scale);
-									sol::table lua_object = getObjectTable(obj->getId());
-									if (lua_object.valid()) {
-										lua_object["scale"] = std::to_string(scale);
-									}
+									obj->markLuaDirty(SpineObject::LuaScale);
 								}
 							});
 
@@ -868,7 +779,7 @@ void Game::setupLuaFunctions()
 							[this](float max_speed)
 							{
 								player->setMaxSpeed(max_speed);
-								(*lua_state)["scenes"]["cross_scene"]["items"]["player"]["max_speed"] = max_speed;
+								player->markLuaDirty(SpineObject::LuaMaxSpeed);
 							});
 
 	/// Create a game object from a Spine file
@@ -879,9 +790,8 @@ void Game::setupLuaFunctions()
                             [this](const std::string& spine_file, const std::string& id, float scale)
 							{
         auto interactable = currentScene->createObject(spine_file, id, scale);
-        interactable->toLuaState();
-
         add(std::static_pointer_cast<SpineObject>(interactable));
+        interactable->toLuaState();
     });
 
     /// Playing an audio file.
@@ -1020,6 +930,7 @@ void Game::setupLuaFunctions()
                             [this](const float scale)
 							{
         player->skeleton->skeleton->setScaleX(scale);
+        player->skeleton->wake();
     });
 
     /// Set the language
@@ -1058,6 +969,11 @@ void Game::setupLuaFunctions()
                             [this]()
 							{
         gameObjects.clear();
+        objectIds.clear();
+        hitIndex.clear();
+        boundsQueue.clear();
+        pointerHit = std::nullopt;
+        scriptCache.clear();
         lua_state = {};
         currentScene = nullptr;
         player = nullptr;
@@ -1,10 +1,33 @@
 #include <jngl/init.hpp>
+#include "benchmark_run.hpp"
 #include "game.hpp"
+#include "scene_generator.hpp"
 
-#ifndef NDEBUG
-void pac_unload_file(const char* path)
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#ifdef ALPACA_COUNT_ALLOCATIONS
+// Counts allocations for --benchmark
+void* operator new(const std::size_t size)
+{
+	BenchmarkRun::allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
 {
-	jngl::unload(path);
+	std::free(ptr);
 }
 #endif
 
@@ -28,9 +51,21 @@ jngl::AppParameters jnglInit()
 
 	jngl::AppParameters params;
 	auto args = jngl::getArgs();
-	if (args.size() == 1 && args[0] == "--fullscreen") {
+	if (std::find(args.begin(), args.end(), "--fullscreen") != args.end()) {
 		params.fullscreen = true;
 	}
+	std::optional<BenchmarkRun::Options> benchmark;
+	std::optional<SceneGenerator::Options> generateScene;
+	try
+	{
+		benchmark = BenchmarkRun::parseArgs(args);
+		generateScene = SceneGenerator::parseArgs(args);
+	}
+	catch (const std::invalid_argument& e)
+	{
+		jngl::error(e.what());
+		std::exit(EXIT_FAILURE);
+	}
 	std::srand(std::time(nullptr));
 
 	std::optional<YAML::Node> config;
@@ -44,7 +79,8 @@ jngl::AppParameters jnglInit()
 		params.maxAspectRatio = {double((*config)["maxAspectRatio"]["x"].as<int>()), double((*config)["maxAspectRatio"]["y"].as<int>())};
 	}
 
-	params.start = [tmp = std::move(config)]() mutable
+	params.start = [tmp = std::move(config), benchmark = std::move(benchmark),
+	                generateScene = std::move(generateScene)]() mutable -> std::shared_ptr<jngl::Work>
 	{
 		if (!tmp)
 		{
@@ -57,8 +93,21 @@ jngl::AppParameters jnglInit()
 		jngl::setFont(config["default_font"].as<std::string>());
 		jngl::setAntiAliasing(config["antiAliasing"].as<bool>());
 		jngl::setIcon(config["icon"].as<std::string>());
+		if (generateScene)
+		{
+			SceneGenerator::generate(*generateScene, config);
+		}
 		auto game = std::make_shared<Game>(config);
+		game->useSavegame = !benchmark;
 		game->init(true);
+		if (generateScene)
+		{
+			game->nextScene = generateScene->name; // --benchmark loads its own scene
+		}
+		if (benchmark)
+		{
+			return std::make_shared<BenchmarkRun>(game, std::move(*benchmark));
+		}
 		return game;
 	};
 
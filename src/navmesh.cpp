@@ -0,0 +1,568 @@
+#include "navmesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+/// > 0 if b lies counter-clockwise of a as seen from o
+double cross(const jngl::Vec2 o, const jngl::Vec2 a, const jngl::Vec2 b) {
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+double signedArea(const std::vector<jngl::Vec2>& polygon) {
+	double area = 0;
+	for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+		area += polygon[j].x * polygon[i].y - polygon[i].x * polygon[j].y;
+	}
+	return area / 2;
+}
+
+/// Open polygon without the repeated first vertex and without duplicated vertices
+std::vector<jngl::Vec2> openPolygon(const std::vector<jngl::Vec2>& closed) {
+	std::vector<jngl::Vec2> polygon;
+	for (const auto& vertex : closed) {
+		if (polygon.empty() || boost::qvm::mag_sqr(vertex - polygon.back()) > 0.01) {
+			polygon.push_back(vertex);
+		}
+	}
+	while (polygon.size() > 1 && boost::qvm::mag_sqr(polygon.front() - polygon.back()) <= 0.01) {
+		polygon.pop_back();
+	}
+	return polygon;
+}
+
+/// Whether the segments cross each other. Touching at an end point doesn't count.
+bool segmentsCross(const jngl::Vec2 a, const jngl::Vec2 b, const jngl::Vec2 c, const jngl::Vec2 d) {
+	const double d1 = cross(c, d, a);
+	const double d2 = cross(c, d, b);
+	const double d3 = cross(a, b, c);
+	const double d4 = cross(a, b, d);
+	return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+}
+
+bool polygonsCross(const std::vector<jngl::Vec2>& a, const std::vector<jngl::Vec2>& b) {
+	for (size_t i = 0, j = a.size() - 1; i < a.size(); j = i++) {
+		for (size_t k = 0, l = b.size() - 1; k < b.size(); l = k++) {
+			if (segmentsCross(a[j], a[i], b[l], b[k])) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool contains(const std::vector<jngl::Vec2>& polygon, const jngl::Vec2 point) {
+	bool inside = false;
+	for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+		const auto& a = polygon[i];
+		const auto& b = polygon[j];
+		if ((a.y > point.y) != (b.y > point.y) &&
+		    point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+/// Whether the direction from v to p points into the walkable area, which is on the left of the
+/// edges prev -> v -> next
+bool locallyInside(const jngl::Vec2 prev, const jngl::Vec2 v, const jngl::Vec2 next,
+                   const jngl::Vec2 p) {
+	if (cross(prev, v, next) > 0) {
+		return cross(v, next, p) > 0 && cross(v, p, prev) > 0;
+	}
+	return cross(v, next, p) > 0 || cross(v, p, prev) > 0;
+}
+
+/// > 0 if d lies inside of the circumcircle of the counter-clockwise triangle a, b, c
+double inCircle(const jngl::Vec2 a, const jngl::Vec2 b, const jngl::Vec2 c, const jngl::Vec2 d) {
+	const double ax = a.x - d.x;
+	const double ay = a.y - d.y;
+	const double bx = b.x - d.x;
+	const double by = b.y - d.y;
+	const double cx = c.x - d.x;
+	const double cy = c.y - d.y;
+	return (ax * ax + ay * ay) * (bx * cy - cx * by) - (bx * bx + by * by) * (ax * cy - cx * ay) +
+	       (cx * cx + cy * cy) * (ax * by - bx * ay);
+}
+
+/// For counter-clockwise triangles, points on the edges count as inside
+bool inTriangle(const jngl::Vec2 p, const jngl::Vec2 a, const jngl::Vec2 b, const jngl::Vec2 c) {
+	return cross(a, b, p) >= 0 && cross(b, c, p) >= 0 && cross(c, a, p) >= 0;
+}
+
+} // namespace
+
+bool NavMesh::build(const std::vector<jngl::Vec2>& walkableArea,
+                    const std::vector<std::vector<jngl::Vec2>>& obstacles) {
+	clear();
+	auto outer = openPolygon(walkableArea);
+	if (outer.size() < 3) {
+		return false;
+	}
+	// Counter-clockwise outer border and clockwise holes, so that the walkable area is always on
+	// the left of an edge
+	if (signedArea(outer) < 0) {
+		std::reverse(outer.begin(), outer.end());
+	}
+	std::vector<std::vector<jngl::Vec2>> holes;
+	for (const auto& obstacle : obstacles) {
+		auto hole = openPolygon(obstacle);
+		if (hole.size() < 3) {
+			continue;
+		}
+		const bool crossesBorder = polygonsCross(outer, hole);
+		const bool inside = std::all_of(hole.begin(), hole.end(),
+		                                [&](const jngl::Vec2 p) { return contains(outer, p); });
+		if (!crossesBorder && !inside &&
+		    std::none_of(hole.begin(), hole.end(),
+		                 [&](const jngl::Vec2 p) { return contains(outer, p); })) {
+			continue; // completely outside of the walkable area
+		}
+		if (crossesBorder || !inside) {
+			return false;
+		}
+		for (const auto& other : holes) {
+			if (polygonsCross(hole, other) || contains(other, hole[0]) || contains(hole, other[0])) {
+				return false;
+			}
+		}
+		if (signedArea(hole) > 0) {
+			std::reverse(hole.begin(), hole.end());
+		}
+		holes.emplace_back(std::move(hole));
+	}
+
+	vertices = outer;
+	std::vector<uint32_t> ring(outer.size());
+	std::iota(ring.begin(), ring.end(), 0);
+
+	// Cut each hole open by a bridge to a visible vertex, starting with the rightmost hole so that
+	// the bridges don't cross holes which haven't been merged yet
+	std::vector<std::pair<uint32_t, uint32_t>> holeRanges; // first vertex and size of each hole
+	for (const auto& hole : holes) {
+		holeRanges.emplace_back(static_cast<uint32_t>(vertices.size()),
+		                        static_cast<uint32_t>(hole.size()));
+		vertices.insert(vertices.end(), hole.begin(), hole.end());
+	}
+	const auto rightmost = [&](const std::pair<uint32_t, uint32_t>& hole) {
+		uint32_t best = hole.first;
+		for (uint32_t i = hole.first; i < hole.first + hole.second; ++i) {
+			if (vertices[i].x > vertices[best].x) {
+				best = i;
+			}
+		}
+		return best;
+	};
+	std::sort(holeRanges.begin(), holeRanges.end(), [&](const auto& a, const auto& b) {
+		return vertices[rightmost(a)].x > vertices[rightmost(b)].x;
+	});
+
+	std::vector<size_t> candidates;
+	for (size_t h = 0; h < holeRanges.size(); ++h) {
+		const auto [first, size] = holeRanges[h];
+		const uint32_t m = rightmost(holeRanges[h]);
+		const jngl::Vec2 mPos = vertices[m];
+		std::vector<jngl::Vec2> ringPolygon;
+		ringPolygon.reserve(ring.size());
+		for (const auto index : ring) {
+			ringPolygon.push_back(vertices[index]);
+		}
+		const std::vector<jngl::Vec2> hole(vertices.begin() + first, vertices.begin() + first + size);
+
+		const jngl::Vec2 mPrev = vertices[first + (m - first + size - 1) % size];
+		const jngl::Vec2 mNext = vertices[first + (m - first + 1) % size];
+
+		const auto blocked = [&](const size_t k) {
+			const jngl::Vec2 p = vertices[ring[k]];
+			// Earlier bridges duplicated vertices, only one of the copies faces the right way
+			if (!locallyInside(vertices[ring[(k + ring.size() - 1) % ring.size()]], p,
+			                   vertices[ring[(k + 1) % ring.size()]], mPos) ||
+			    !locallyInside(mPrev, mPos, mNext, p)) {
+				return true;
+			}
+			for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+				if (segmentsCross(mPos, p, vertices[ring[j]], vertices[ring[i]])) {
+					return true;
+				}
+			}
+			for (size_t other = h; other < holeRanges.size(); ++other) {
+				const auto [otherFirst, otherSize] = holeRanges[other];
+				for (uint32_t i = 0, j = otherSize - 1; i < otherSize; j = i++) {
+					if (segmentsCross(mPos, p, vertices[otherFirst + j], vertices[otherFirst + i])) {
+						return true;
+					}
+				}
+			}
+			// The bridge has to run through the walkable area, not along the outside of the border
+			const jngl::Vec2 middle = (mPos + p) * 0.5;
+			return !contains(ringPolygon, middle) || contains(hole, middle);
+		};
+
+		candidates.resize(ring.size());
+		std::iota(candidates.begin(), candidates.end(), 0);
+		std::sort(candidates.begin(), candidates.end(), [&](const size_t a, const size_t b) {
+			return boost::qvm::mag_sqr(vertices[ring[a]] - mPos) <
+			       boost::qvm::mag_sqr(vertices[ring[b]] - mPos);
+		});
+		const auto bridge = std::find_if(candidates.begin(), candidates.end(),
+		                                 [&](const size_t k) { return !blocked(k); });
+		if (bridge == candidates.end()) {
+			clear();
+			return false;
+		}
+		const size_t k = *bridge;
+
+		// ring[0..k], the hole starting and ending at m, ring[k] again, ring[k + 1..]
+		std::vector<uint32_t> merged(ring.begin(), ring.begin() + static_cast<ptrdiff_t>(k) + 1);
+		for (uint32_t i = 0; i <= size; ++i) {
+			merged.push_back(first + (m - first + i) % size);
+		}
+		merged.insert(merged.end(), ring.begin() + static_cast<ptrdiff_t>(k), ring.end());
+		ring = std::move(merged);
+	}
+
+	if (!triangulate(std::move(ring))) {
+		clear();
+		return false;
+	}
+	connectTriangles();
+	// Ear clipping creates lots of long and thin triangles, which make for bad paths
+	for (int pass = 0; pass < 100 && flipToDelaunay(); ++pass) {
+		connectTriangles();
+	}
+	return true;
+}
+
+bool NavMesh::triangulate(std::vector<uint32_t> ring) {
+	constexpr double EPSILON = 1e-9;
+	// Ear clipping: cut off convex corners whose triangle doesn't contain any other vertex
+	size_t i = 0;
+	size_t withoutEar = 0;
+	while (ring.size() > 3) {
+		if (withoutEar > ring.size()) {
+			// No ear left, remove a degenerated vertex on a straight line if there is one
+			bool removed = false;
+			for (size_t j = 0; j < ring.size(); ++j) {
+				const auto& a = vertices[ring[(j + ring.size() - 1) % ring.size()]];
+				const auto& b = vertices[ring[j]];
+				const auto& c = vertices[ring[(j + 1) % ring.size()]];
+				if (std::abs(cross(a, b, c)) <= EPSILON) {
+					ring.erase(ring.begin() + static_cast<ptrdiff_t>(j));
+					removed = true;
+					break;
+				}
+			}
+			if (!removed) {
+				return false;
+			}
+			withoutEar = 0;
+			continue;
+		}
+		i %= ring.size();
+		const uint32_t prev = ring[(i + ring.size() - 1) % ring.size()];
+		const uint32_t cur = ring[i];
+		const uint32_t next = ring[(i + 1) % ring.size()];
+		const auto& a = vertices[prev];
+		const auto& b = vertices[cur];
+		const auto& c = vertices[next];
+
+		bool ear = cross(a, b, c) > EPSILON;
+		if (ear) {
+			const double minX = std::min({ a.x, b.x, c.x });
+			const double maxX = std::max({ a.x, b.x, c.x });
+			const double minY = std::min({ a.y, b.y, c.y });
+			const double maxY = std::max({ a.y, b.y, c.y });
+			for (const auto other : ring) {
+				// Bridges duplicate vertices, those are corners of the triangle and don't count
+				if (other == prev || other == cur || other == next) {
+					continue;
+				}
+				const auto& p = vertices[other];
+				if (p.x < minX || p.x > maxX || p.y < minY || p.y > maxY) {
+					continue;
+				}
+				if (inTriangle(p, a, b, c)) {
+					ear = false;
+					break;
+				}
+			}
+		}
+		if (!ear) {
+			++i;
+			++withoutEar;
+			continue;
+		}
+		triangles.push_back(Triangle{ { prev, cur, next } });
+		ring.erase(ring.begin() + static_cast<ptrdiff_t>(i));
+		withoutEar = 0;
+		if (i > 0) {
+			--i; // the previous corner might have become an ear
+		}
+	}
+	const auto& a = vertices[ring[0]];
+	const auto& b = vertices[ring[1]];
+	const auto& c = vertices[ring[2]];
+	if (cross(a, b, c) > EPSILON) {
+		triangles.push_back(Triangle{ { ring[0], ring[1], ring[2] } });
+	}
+	return !triangles.empty();
+}
+
+void NavMesh::connectTriangles() {
+	struct HalfEdge {
+		uint64_t key;
+		int32_t triangle;
+		int32_t index;
+	};
+	edges.clear();
+	std::vector<HalfEdge> halfEdges;
+	halfEdges.reserve(triangles.size() * 3);
+	for (size_t t = 0; t < triangles.size(); ++t) {
+		for (int i = 0; i < 3; ++i) {
+			const uint64_t a = triangles[t].vertices[i];
+			const uint64_t b = triangles[t].vertices[(i + 1) % 3];
+			halfEdges.push_back(
+			    HalfEdge{ (std::min(a, b) << 32) | std::max(a, b), static_cast<int32_t>(t), i });
+		}
+	}
+	std::sort(halfEdges.begin(), halfEdges.end(),
+	          [](const HalfEdge& a, const HalfEdge& b) { return a.key < b.key; });
+	for (size_t i = 0; i + 1 < halfEdges.size(); ++i) {
+		const auto& first = halfEdges[i];
+		const auto& second = halfEdges[i + 1];
+		if (first.key != second.key) {
+			continue;
+		}
+		// Edges shared by more than two triangles only occur in degenerated meshes, skip them
+		if (i + 2 < halfEdges.size() && halfEdges[i + 2].key == first.key) {
+			while (i + 1 < halfEdges.size() && halfEdges[i + 1].key == first.key) {
+				++i;
+			}
+			continue;
+		}
+		const auto edge = static_cast<int32_t>(edges.size());
+		const auto& triangle = triangles[first.triangle];
+		edges.push_back(Edge{ { first.triangle, second.triangle },
+		                      (vertices[triangle.vertices[first.index]] +
+		                       vertices[triangle.vertices[(first.index + 1) % 3]]) *
+		                          0.5 });
+		triangles[first.triangle].neighbours[first.index] = second.triangle;
+		triangles[first.triangle].edges[first.index] = edge;
+		triangles[second.triangle].neighbours[second.index] = first.triangle;
+		triangles[second.triangle].edges[second.index] = edge;
+		++i;
+	}
+}
+
+bool NavMesh::flipToDelaunay() {
+	// Each triangle is flipped at most once per pass, because its neighbours are outdated after that
+	std::vector<bool> flipped(triangles.size(), false);
+	bool any = false;
+	for (size_t t = 0; t < triangles.size(); ++t) {
+		for (int i = 0; i < 3 && !flipped[t]; ++i) {
+			const int32_t u = triangles[t].neighbours[i];
+			if (u < 0 || flipped[u]) {
+				continue;
+			}
+			const uint32_t a = triangles[t].vertices[i];
+			const uint32_t b = triangles[t].vertices[(i + 1) % 3];
+			const uint32_t c = triangles[t].vertices[(i + 2) % 3];
+			uint32_t d = 0;
+			for (const auto vertex : triangles[u].vertices) {
+				if (vertex != a && vertex != b) {
+					d = vertex;
+				}
+			}
+			const auto &pa = vertices[a], &pb = vertices[b], &pc = vertices[c], &pd = vertices[d];
+			// Only flip if the quad is convex, i.e. both new triangles are counter-clockwise
+			if (inCircle(pa, pb, pc, pd) <= 1e-6 || cross(pa, pd, pc) <= 1e-9 ||
+			    cross(pb, pc, pd) <= 1e-9) {
+				continue;
+			}
+			triangles[t] = Triangle{ { a, d, c } };
+			triangles[u] = Triangle{ { b, c, d } };
+			flipped[t] = flipped[u] = true;
+			any = true;
+		}
+	}
+	return any;
+}
+
+bool NavMesh::empty() const {
+	return triangles.empty();
+}
+
+void NavMesh::clear() {
+	vertices.clear();
+	triangles.clear();
+	edges.clear();
+}
+
+const std::vector<jngl::Vec2>& NavMesh::getVertices() const {
+	return vertices;
+}
+
+const std::vector<NavMesh::Triangle>& NavMesh::getTriangles() const {
+	return triangles;
+}
+
+const std::vector<NavMesh::Edge>& NavMesh::getEdges() const {
+	return edges;
+}
+
+int NavMesh::findTriangle(const jngl::Vec2 point) const {
+	for (size_t t = 0; t < triangles.size(); ++t) {
+		const auto& v = triangles[t].vertices;
+		if (inTriangle(point, vertices[v[0]], vertices[v[1]], vertices[v[2]])) {
+			return static_cast<int>(t);
+		}
+	}
+	return -1;
+}
+
+std::deque<jngl::Vec2> NavMesh::findPath(const jngl::Vec2 start, const jngl::Vec2 target) const {
+	const int startTriangle = findTriangle(start);
+	const int targetTriangle = findTriangle(target);
+	if (startTriangle < 0 || targetTriangle < 0) {
+		return {};
+	}
+	if (startTriangle == targetTriangle) {
+		return { start, target };
+	}
+
+	// start and target are the two nodes after the edges
+	const auto startNode = static_cast<uint32_t>(edges.size());
+	const auto targetNode = startNode + 1;
+	const auto position = [&](const uint32_t node) {
+		if (node < startNode) {
+			return edges[node].middle;
+		}
+		return node == startNode ? start : target;
+	};
+	const auto distance = [](const jngl::Vec2 a, const jngl::Vec2 b) {
+		return static_cast<float>(boost::qvm::mag(a - b));
+	};
+	const bool found = search.find(
+	    edges.size() + 2, startNode, targetNode,
+	    [&](const uint32_t node, const auto& visit) {
+		    const jngl::Vec2 from = position(node);
+		    const auto visitTriangle = [&](const int32_t t) {
+			    for (const auto edge : triangles[t].edges) {
+				    if (edge >= 0 && static_cast<uint32_t>(edge) != node) {
+					    visit(static_cast<uint32_t>(edge), distance(from, edges[edge].middle));
+				    }
+			    }
+			    if (t == targetTriangle) {
+				    visit(targetNode, distance(from, target));
+			    }
+		    };
+		    if (node == startNode) {
+			    visitTriangle(startTriangle);
+		    } else {
+			    for (const auto t : edges[node].triangles) {
+				    visitTriangle(t);
+			    }
+		    }
+	    },
+	    [&](const uint32_t node) { return distance(position(node), target); });
+	if (!found) {
+		return {};
+	}
+
+	// The edges crossed on the way, seen in walking direction
+	const auto& nodes = search.getPath();
+	portals.clear();
+	portals.push_back(Portal{ start, start });
+	int32_t current = startTriangle;
+	int32_t previous = -1;
+	for (size_t i = 1; i + 1 < nodes.size(); ++i) {
+		const auto edge = static_cast<int32_t>(nodes[i]);
+		if (std::find(triangles[current].edges.begin(), triangles[current].edges.end(), edge) ==
+		    triangles[current].edges.end()) {
+			// Only possible with ties: the path touched the last edge without crossing it
+			portals.pop_back();
+			std::swap(current, previous);
+		}
+		const auto& triangle = triangles[current];
+		const auto e = std::find(triangle.edges.begin(), triangle.edges.end(), edge) -
+		               triangle.edges.begin();
+		// Triangles are counter-clockwise, so the walkable side is left of each edge and its end
+		// is on the left when leaving the triangle through it
+		portals.push_back(
+		    Portal{ vertices[triangle.vertices[(e + 1) % 3]], vertices[triangle.vertices[e]] });
+		previous = current;
+		current = edges[edge].triangles[0] == current ? edges[edge].triangles[1]
+		                                              : edges[edge].triangles[0];
+	}
+	portals.push_back(Portal{ target, target });
+
+	// If start or target lie on an edge or corner, the triangles on both sides of the edges through
+	// that point contain it. Those portals don't narrow the funnel, but a funnel starting on its own
+	// side would degenerate.
+	const auto onPortal = [](const jngl::Vec2 point, const Portal& portal) {
+		return std::abs(cross(portal.left, portal.right, point)) <=
+		       1e-6 * boost::qvm::mag(portal.right - portal.left);
+	};
+	size_t first = 1;
+	while (first + 1 < portals.size() && onPortal(start, portals[first])) {
+		++first;
+	}
+	portals.erase(portals.begin() + 1, portals.begin() + static_cast<ptrdiff_t>(first));
+	size_t last = portals.size() - 1;
+	while (last > 1 && onPortal(target, portals[last - 1])) {
+		--last;
+	}
+	portals.erase(portals.begin() + static_cast<ptrdiff_t>(last), portals.end() - 1);
+
+	// Simple stupid funnel algorithm, see http://digestingduck.blogspot.com/2010/03/simple-stupid-funnel-algorithm.html
+	std::deque<jngl::Vec2> path{ start };
+	jngl::Vec2 apex = start;
+	jngl::Vec2 left = start;
+	jngl::Vec2 right = start;
+	size_t leftIndex = 0;
+	size_t rightIndex = 0;
+	const auto same = [](const jngl::Vec2 a, const jngl::Vec2 b) {
+		return boost::qvm::mag_sqr(a - b) < 0.01;
+	};
+	for (size_t i = 1; i < portals.size(); ++i) {
+		const auto& portal = portals[i];
+
+		// Narrow the right side of the funnel
+		if (cross(apex, right, portal.right) >= 0) {
+			if (same(apex, right) || cross(apex, left, portal.right) < 0) {
+				right = portal.right;
+				rightIndex = i;
+			} else {
+				// The right side crossed the left one, the left corner becomes the new apex
+				apex = left;
+				path.push_back(apex);
+				right = apex;
+				rightIndex = leftIndex;
+				i = leftIndex;
+				continue;
+			}
+		}
+
+		// Narrow the left side of the funnel
+		if (cross(apex, left, portal.left) <= 0) {
+			if (same(apex, left) || cross(apex, right, portal.left) > 0) {
+				left = portal.left;
+				leftIndex = i;
+			} else {
+				apex = right;
+				path.push_back(apex);
+				left = apex;
+				leftIndex = rightIndex;
+				i = rightIndex;
+				continue;
+			}
+		}
+	}
+	if (!same(path.back(), target)) {
+		path.push_back(target);
+	}
+	return path;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "path_search.hpp"
+
+#include <jngl/Vec2.hpp>
+
+#include <array>
+#include <deque>
+#include <vector>
+
+/// Triangulation of the walkable area with the obstacles cut out as holes. Paths are searched over
+/// the triangles and then straightened with the funnel algorithm, so queries scale with the number
+/// of triangles instead of the number of corner pairs.
+class NavMesh {
+public:
+	struct Triangle {
+		std::array<uint32_t, 3> vertices;
+		/// Triangle on the other side of the edge from vertices[i] to vertices[(i + 1) % 3], -1 if
+		/// that edge is part of the border
+		std::array<int32_t, 3> neighbours{ -1, -1, -1 };
+		/// Index into getEdges() of the same edge, -1 for the border
+		std::array<int32_t, 3> edges{ -1, -1, -1 };
+	};
+
+	/// An edge between two triangles. The path search runs from edge to edge, because the
+	/// middles of the edges approximate the distances much better than the centers of the
+	/// (often long and thin) triangles would.
+	struct Edge {
+		std::array<int32_t, 2> triangles;
+		jngl::Vec2 middle;
+	};
+
+	/// Polygons are closed, i.e. the first vertex is repeated at the end, like in VisibilityGraph.
+	/// Obstacles completely outside of the walkable area are ignored. Returns false and leaves the
+	/// mesh empty if the polygons can't be triangulated, e.g. because obstacles overlap each other or
+	/// the border of the walkable area.
+	bool build(const std::vector<jngl::Vec2>& walkableArea,
+	           const std::vector<std::vector<jngl::Vec2>>& obstacles);
+
+	bool empty() const;
+	void clear();
+
+	const std::vector<jngl::Vec2>& getVertices() const;
+	const std::vector<Triangle>& getTriangles() const;
+	const std::vector<Edge>& getEdges() const;
+
+	/// Index of the triangle containing point or -1
+	int findTriangle(jngl::Vec2 point) const;
+
+	/// Shortest path from start to target, including both. Empty if start or target aren't on the
+	/// mesh or target can't be reached.
+	std::deque<jngl::Vec2> findPath(jngl::Vec2 start, jngl::Vec2 target) const;
+
+private:
+	bool triangulate(std::vector<uint32_t> ring);
+	void connectTriangles();
+	bool flipToDelaunay();
+
+	std::vector<jngl::Vec2> vertices;
+	std::vector<Triangle> triangles;
+	std::vector<Edge> edges;
+
+	mutable PathSearch search;
+	struct Portal {
+		jngl::Vec2 left;
+		jngl::Vec2 right;
+	};
+	mutable std::vector<Portal> portals;
+};
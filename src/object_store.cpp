@@ -0,0 +1,88 @@
+#include "object_store.hpp"
+
+#include "spine_object.hpp"
+
+ObjectHandle ObjectStore::insert(std::shared_ptr<SpineObject> object) {
+	if (object->handle) {
+		return object->handle;
+	}
+	uint32_t index;
+	if (freeSlots.empty()) {
+		index = static_cast<uint32_t>(slots.size());
+		slots.emplace_back();
+	} else {
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	auto& slot = slots[index];
+	slot.object = object;
+	const ObjectHandle handle{ index, slot.generation };
+	object->handle = handle;
+	object->removed = false;
+	if (!object->ordered) {
+		pending.emplace_back(std::move(object));
+	}
+	return handle;
+}
+
+void ObjectStore::erase(const std::shared_ptr<SpineObject>& object) {
+	const auto handle = object->handle;
+	if (!handle || get(handle) != object) {
+		return;
+	}
+	auto& slot = slots[handle.index];
+	slot.object.reset();
+	if (++slot.generation == 0) {
+		slot.generation = 1;
+	}
+	freeSlots.push_back(handle.index);
+	object->handle = {};
+	object->removed = true;
+	hasErased = true;
+}
+
+void ObjectStore::clear() {
+	freeSlots.clear();
+	for (uint32_t i = 0; i < slots.size(); ++i) {
+		auto& slot = slots[i];
+		if (slot.object) {
+			slot.object->handle = {};
+			slot.object.reset();
+			if (++slot.generation == 0) {
+				slot.generation = 1;
+			}
+		}
+		freeSlots.push_back(i);
+	}
+	pending.clear();
+	hasErased = false;
+	order.clear();
+}
+
+std::shared_ptr<SpineObject> ObjectStore::get(const ObjectHandle handle) const {
+	if (!handle || handle.index >= slots.size()) {
+		return nullptr;
+	}
+	const auto& slot = slots[handle.index];
+	if (slot.generation != handle.generation) {
+		return nullptr;
+	}
+	return slot.object;
+}
+
+bool ObjectStore::update() {
+	// Erased objects are dropped by DepthOrder::update() in the same pass that moves dirty objects
+	const size_t sizeBefore = order.size();
+	order.update(hasErased);
+	bool changed = hasErased && order.size() != sizeBefore;
+	hasErased = false;
+	for (auto& object : pending) {
+		// The same object might be pending twice if it has been erased and inserted again
+		if (!object->removed && !object->ordered) {
+			order.insert(std::move(object));
+			changed = true;
+		}
+	}
+	pending.clear();
+	return changed;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "depth_order.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SpineObject;
+
+/// Refers to an object in an ObjectStore. Unlike a shared_ptr it doesn't keep the object alive and
+/// ObjectStore::get() returns nullptr once the object has been removed, even if its slot has been
+/// reused since.
+struct ObjectHandle {
+	uint32_t index = 0;
+	/// 0 is never used by a slot, so a default constructed handle is invalid
+	uint32_t generation = 0;
+
+	explicit operator bool() const { return generation != 0; }
+	bool operator==(const ObjectHandle&) const = default;
+};
+
+/// Owns all game objects of the running game. Removal is O(1), the objects are iterated in depth
+/// order (see DepthOrder) and added and removed objects only show up in the iteration after the
+/// next update(), so it's safe to add and remove objects while iterating.
+class ObjectStore {
+public:
+	using const_iterator = DepthOrder::const_iterator;
+	using const_reverse_iterator = DepthOrder::const_reverse_iterator;
+
+	/// Returns the handle of the object, which is valid right away. Inserting an object twice
+	/// returns the same handle.
+	ObjectHandle insert(std::shared_ptr<SpineObject>);
+
+	/// Invalidates the handle of the object
+	void erase(const std::shared_ptr<SpineObject>&);
+
+	/// Invalidates all handles
+	void clear();
+
+	/// Returns nullptr if the object has been removed
+	std::shared_ptr<SpineObject> get(ObjectHandle) const;
+
+	/// Applies inserts and erases and moves objects whose z changed to their new place. Returns true
+	/// if objects have been added or removed.
+	bool update();
+
+	const_iterator begin() const { return order.begin(); }
+	const_iterator end() const { return order.end(); }
+	const_reverse_iterator rbegin() const { return order.rbegin(); }
+	const_reverse_iterator rend() const { return order.rend(); }
+	size_t size() const { return order.size(); }
+	bool empty() const { return order.empty(); }
+
+private:
+	struct Slot {
+		std::shared_ptr<SpineObject> object;
+		uint32_t generation = 1;
+	};
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+
+	/// Inserted since the last update()
+	std::vector<std::shared_ptr<SpineObject>> pending;
+	bool hasErased = false;
+
+	DepthOrder order;
+};
@@ -0,0 +1,27 @@
+#include "path_search.hpp"
+
+void PathSearch::reset(const size_t nodeCount) {
+	open.clear();
+	if (nodeCount > cost.size()) {
+		cost.resize(nodeCount);
+		parent.resize(nodeCount);
+		seenInSearch.resize(nodeCount, 0);
+		closedInSearch.resize(nodeCount, 0);
+	}
+	if (++search == 0) {
+		// Wrapped around, old marks could be mistaken for ones of this search
+		std::fill(seenInSearch.begin(), seenInSearch.end(), 0);
+		std::fill(closedInSearch.begin(), closedInSearch.end(), 0);
+		search = 1;
+	}
+}
+
+void PathSearch::buildPath(uint32_t last) {
+	path.clear();
+	while (parent[last] != last) {
+		path.push_back(last);
+		last = parent[last];
+	}
+	path.push_back(last);
+	std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// A* over a graph whose nodes are identified by indices. All buffers are kept between searches,
+/// so once they've grown to the size of the graph a search doesn't allocate any more.
+class PathSearch {
+public:
+	/// neighbours(node, visit) has to call visit(neighbour, cost) for every edge of node and
+	/// heuristic(node) must not overestimate the cost from node to goal. Returns false if goal
+	/// can't be reached. getPath() then leads to the reached node with the smallest heuristic.
+	template <class Neighbours, class Heuristic>
+	bool find(size_t nodeCount, uint32_t start, uint32_t goal, Neighbours&& neighbours,
+	          Heuristic&& heuristic);
+
+	/// Node indices from start to goal, including both
+	const std::vector<uint32_t>& getPath() const {
+		return path;
+	}
+
+private:
+	void reset(size_t nodeCount);
+	void buildPath(uint32_t last);
+
+	struct OpenEntry {
+		float f;
+		uint32_t node;
+		bool operator<(const OpenEntry& other) const {
+			return f > other.f; // std::push_heap builds a max heap, we want the smallest f on top
+		}
+	};
+	/// Binary heap, nodes whose cost improved are pushed again and stale entries skipped
+	std::vector<OpenEntry> open;
+	std::vector<float> cost;
+	std::vector<uint32_t> parent;
+	/// cost and parent of a node are only valid if its entry equals the current search
+	std::vector<uint32_t> seenInSearch;
+	std::vector<uint32_t> closedInSearch;
+	uint32_t search = 0;
+	std::vector<uint32_t> path;
+};
+
+template <class Neighbours, class Heuristic>
+bool PathSearch::find(const size_t nodeCount, const uint32_t start, const uint32_t goal,
+                      Neighbours&& neighbours, Heuristic&& heuristic) {
+	reset(nodeCount);
+	cost[start] = 0;
+	parent[start] = start;
+	seenInSearch[start] = search;
+	open.push_back(OpenEntry{ heuristic(start), start });
+
+	uint32_t closest = start;
+	float closestDistance = std::numeric_limits<float>::infinity();
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end());
+		const uint32_t current = open.back().node;
+		open.pop_back();
+		if (closedInSearch[current] == search) {
+			continue;
+		}
+		if (current == goal) {
+			buildPath(goal);
+			return true;
+		}
+		closedInSearch[current] = search;
+		if (const float distance = heuristic(current); distance < closestDistance) {
+			closestDistance = distance;
+			closest = current;
+		}
+
+		const float currentCost = cost[current];
+		neighbours(current, [&](const uint32_t neighbour, const float edgeCost) {
+			if (closedInSearch[neighbour] == search) {
+				return;
+			}
+			const float newCost = currentCost + edgeCost;
+			if (seenInSearch[neighbour] == search && newCost >= cost[neighbour]) {
+				return;
+			}
+			seenInSearch[neighbour] = search;
+			cost[neighbour] = newCost;
+			parent[neighbour] = current;
+			open.push_back(OpenEntry{ newCost + heuristic(neighbour), neighbour });
+			std::push_heap(open.begin(), open.end());
+		});
+	}
+	buildPath(closest);
+	return false;
+}
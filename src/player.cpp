@@ -28,16 +28,16 @@ void Player::setDirection()
 {
     if (auto _game = game.lock())
     {
-        if ((*_game->lua_state)["config"]["player_max_speed"] == 0.0)
+        const auto& config = _game->getEngineConfig();
+        if (config.playerMaxSpeed == 0.0)
         {
             return;
         }
 
-        if (currentAnimation != (*_game->lua_state)["config"]["player_walk_animation"])
+        if (currentAnimation != config.playerWalkAnimation)
         {
-            currentAnimation = (*_game->lua_state)["config"]["player_walk_animation"];
-            (*_game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["animation"] = currentAnimation;
-            (*_game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["loop_animation"] = true;
+            currentAnimation = config.playerWalkAnimation;
+            setLuaAnimation(currentAnimation, true);
             playAnimation(0, currentAnimation, true);
         }
 
@@ -75,7 +75,7 @@ void Player::addTargetPositionImmediately(jngl::Vec2 target, std::optional<sol::
     {
         if (boost::qvm::mag_sqr(target_position - target) < 5 || (!path.empty() && boost::qvm::mag_sqr(path.back() - target) < 5 ))
         {
-            position = target;
+            setPosition(target);
         }
         path.clear();
         if (boost::qvm::mag_sqr(target - position) > 0.5)
@@ -117,9 +117,9 @@ bool Player::step(bool /*force*/)
         }
 
         jngl::Vec2 tmp_target_position = target_position - position;
-        if (boost::qvm::mag_sqr(tmp_target_position - jngl::Vec2(0, 0)) < 0.5 && currentAnimation == (*_game->lua_state)["config"]["player_walk_animation"])
+        if (boost::qvm::mag_sqr(tmp_target_position - jngl::Vec2(0, 0)) < 0.5 && currentAnimation == _game->getEngineConfig().playerWalkAnimation)
         {
-            currentAnimation = (*_game->lua_state)["config"]["player_idle_animation"];
+            currentAnimation = _game->getEngineConfig().playerIdleAnimation;
             // Callback to Lua
             auto old_callback = walk_callback;
             if (walk_callback)
@@ -132,32 +132,32 @@ bool Player::step(bool /*force*/)
                 walk_callback = std::nullopt;
             }
 
-            if (currentAnimation == (*_game->lua_state)["config"]["player_idle_animation"])
+            if (currentAnimation == _game->getEngineConfig().playerIdleAnimation)
             {
-                (*_game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["animation"] = currentAnimation;
-                (*_game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["loop_animation"] = true;
+                setLuaAnimation(currentAnimation, true);
 
                 playAnimation(0, currentAnimation, true);
             }
         }
 
         if (_game->getDialogManager()->isActive() || _game->getInactivLayerBorder() > layer) {
-            skeleton->step();
-            bounds->update(*skeleton->skeleton, true);
             return false;
         }
 
-        float max_speed = (*_game->lua_state)["config"]["player_max_speed"];
+        float max_speed = _game->getEngineConfig().playerMaxSpeed;
         auto magnitude = std::sqrt(boost::qvm::dot(tmp_target_position, tmp_target_position));
         if (magnitude != 0 && magnitude > max_speed)
         {
             tmp_target_position *= max_speed / magnitude;
         }
-        position += tmp_target_position;
+        setPosition(position + tmp_target_position);
 
-        skeleton->skeleton->physicsTranslate(tmp_target_position.x * 2.0, tmp_target_position.y * 2.0);
-        skeleton->step();
-        bounds->update(*skeleton->skeleton, true);
+        // Applied by the next Game::animateObjects
+        if (boost::qvm::mag_sqr(tmp_target_position) > 0)
+        {
+            skeleton->skeleton->physicsTranslate(tmp_target_position.x * 2.0, tmp_target_position.y * 2.0);
+            skeleton->wake();
+        }
 
         // TODO it's still possible to walk outside of the nav mesh. We have to fix that soon.
         // #ifndef NDEBUG
@@ -199,12 +199,10 @@ bool Player::step(bool /*force*/)
         if (_game->pointer->primaryPressed() && interruptible && !_game->pointer->isPrimaryAlreadyHandled())
         {
             const jngl::Vec2 click_position = _game->pointer->getWorldPosition();
-            auto *collision = bounds->containsPoint(
-                                                             static_cast<float>(click_position.x) - static_cast<float>(position.x),
-                                                             static_cast<float>(click_position.y) - static_cast<float>(position.y));
-            if (collision)
+            const auto &hit = _game->getPointerHit();
+            if (hit.object.get() == this)
             {
-                collision_script = collision->getName().buffer();
+                collision_script = hit.box->getName().buffer();
 
                 jngl::debug("clicked player");
                 _game->pointer->setPrimaryHandled();
@@ -215,8 +213,8 @@ bool Player::step(bool /*force*/)
             auto click_distance = boost::qvm::dot(last_click_position - click_position, last_click_position - click_position);
 
             // Return if players current position is the target position
-            double double_click_time = (*_game->lua_state)["config"]["double_click_time"];
-            double max_click_distance = (*_game->lua_state)["config"]["max_click_distance"];
+            const double double_click_time = _game->getEngineConfig().doubleClickTime;
+            const double max_click_distance = _game->getEngineConfig().maxClickDistance;
             if (boost::qvm::mag_sqr(target_position - click_position) < 5 && (time - last_click_time >= double_click_time || click_distance >= max_click_distance))
             {
                 return false;
@@ -238,13 +236,12 @@ bool Player::step(bool /*force*/)
                 path.clear();
                 walk_callback = std::nullopt;
                 path.push_back(click_position);
-                position = click_position;
+                setPosition(click_position);
                 setTargentPosition(click_position);
-                currentAnimation = (*_game->lua_state)["config"]["player_beam_animation"];
-                (*_game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["animation"] = currentAnimation;
-                (*_game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["loop_animation"] = false;
+                currentAnimation = _game->getEngineConfig().playerBeamAnimation;
+                setLuaAnimation(currentAnimation, false);
                 playAnimation(0, currentAnimation, false);
-                addAnimation(0, (*_game->lua_state)["config"]["player_idle_animation"], true, 0);
+                addAnimation(0, _game->getEngineConfig().playerIdleAnimation, true, 0);
             }
             last_click_time = time;
             last_click_position = click_position;
@@ -256,6 +253,14 @@ bool Player::step(bool /*force*/)
     return false;
 }
 
+spine::BoundingBoxAttachment *Player::hitTest(const jngl::Vec2 point) const
+{
+    ensureBounds();
+    const auto x = static_cast<float>(point.x);
+    const auto y = static_cast<float>(point.y);
+    return bounds->aabbContainsPoint(x, y) ? bounds->containsPoint(x, y) : nullptr;
+}
+
 void Player::draw() const
 {
     auto mv = jngl::modelview().translate(position).rotate(getRotation());
@@ -277,12 +282,8 @@ void Player::draw() const
 
 void Player::setTargentPosition(jngl::Vec2 position)
 {
-    if (auto _game = game.lock())
-    {
-        target_position = position;
-        (*_game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["x"] = position.x;
-        (*_game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["y"] = position.y;
-    }
+    target_position = position;
+    setLuaPosition(position);
 }
 
 jngl::Vec2 Player::calcCamPos()
@@ -293,8 +294,9 @@ jngl::Vec2 Player::calcCamPos()
         auto size = jngl::getScreenSize();
         jngl::Vec2 camPos = jngl::Vec2(0, 0);
 
-        int border_x = (*_game->lua_state)["config"]["border"]["x"];
-        int border_y = (*_game->lua_state)["config"]["border"]["y"];
+        // Nested tables aren't behind the config proxy, so border isn't part of EngineConfig
+        const int border_x = (*_game->lua_state)["config"]["border"]["x"];
+        const int border_y = (*_game->lua_state)["config"]["border"]["y"];
 
         if (position.x + border_x > size.x / 2.0 / _game->getCameraZoom())
         {
@@ -327,10 +329,19 @@ void Player::toLuaState()
     }
 }
 
+void Player::writeLuaFields(sol::table& luaObject, const uint8_t fields)
+{
+    SpineObject::writeLuaFields(luaObject, fields);
+    if (fields & LuaMaxSpeed)
+    {
+        luaObject["max_speed"] = getMaxSpeed();
+    }
+}
+
 float Player::getMaxSpeed() const
 {
     if (auto _game = game.lock()) {
-        return (*_game->lua_state)["config"]["player_max_speed"];
+        return _game->getEngineConfig().playerMaxSpeed;
     }
     throw std::runtime_error("Couldn't lock game.");
 }
@@ -16,6 +16,9 @@ public:
 
     void draw() const override;
 
+    /// Every bounding box of the player can be clicked
+    spine::BoundingBoxAttachment *hitTest(jngl::Vec2 point) const override;
+
     void addTargetPosition(jngl::Vec2 target);
     void addTargetPositionImmediately(jngl::Vec2 target, std::optional<sol::function> callback);
     void stop_walking();
@@ -27,6 +30,10 @@ public:
     bool interruptible = true;
     void toLuaState();
 
+protected:
+    /// Also writes max_speed
+    void writeLuaFields(sol::table& luaObject, uint8_t fields) override;
+
 private:
     std::deque<jngl::Vec2> path;
     jngl::Vec2 target_position = jngl::Vec2(0, 0);
@@ -41,9 +41,11 @@ bool Pointer::step(bool)
     {
         jngl::Vec2 screensize = jngl::getScreenSize();
 
-        auto mouse_pose = jngl::getMousePos();
+        // Unchanged if the mouse is ignored, so that the pointer keeps following target_position
+        auto mouse_pose = ignoreMouse ? last_mouse_pose : jngl::getMousePos();
 
-        float gamepad_speed_multiplier = (*_game->lua_state)["config"]["gamepad_speed_multiplier"];
+        const auto& config = _game->getEngineConfig();
+        const float gamepad_speed_multiplier = config.gamepadSpeedMultiplier;
         auto move = control->getMovement() * gamepad_speed_multiplier;
         auto movesec = control->getSecondaryMovement();
         if (boost::qvm::mag_sqr(move - jngl::Vec2(0, 0)) > 0.5)
@@ -70,7 +72,7 @@ bool Pointer::step(bool)
         {
             jngl::Vec2 tmp_target_position = target_position - position;
             auto magnitude = std::sqrt(boost::qvm::dot(tmp_target_position, tmp_target_position));
-            float max_speed = (*_game->lua_state)["config"]["pointer_max_speed"];
+            const float max_speed = config.pointerMaxSpeed;
             if (magnitude != 0 && magnitude > max_speed)
             {
                 tmp_target_position *= max_speed / magnitude;
@@ -85,38 +87,26 @@ bool Pointer::step(bool)
             over = dlgMan->isOverText(position);
         }
         // Region and Object Collision Test nur, wenn kein Dialog läuft.
-        else
+        else if (_game->getPointerHit().object)
         {
-            auto world_pos = getWorldPosition();
-            for (auto obj : _game->gameObjects)
-            {
-                if (obj->getVisible() &&
-                    !(_game->getInactivLayerBorder() > obj->layer) &&
-                    obj->bounds &&
-                    bool(spSkeletonBounds_containsPointNotMatchingName(obj->bounds.get(), "walkable_area", (float)world_pos.x - (float)obj->getPosition().x, (float)world_pos.y - (float)obj->getPosition().y)) &&
-                    bool(spSkeletonBounds_containsPointNotMatchingName(obj->bounds.get(), "non_walkable_area", (float)world_pos.x - (float)obj->getPosition().x, (float)world_pos.y - (float)obj->getPosition().y)))
-                {
-                    over = true;
-                    vibrate();
-                    break;
-                }
-            }
+            over = true;
+            vibrate();
         }
 
         if (over)
         {
-            if (currentAnimation != (*_game->lua_state)["config"]["pointer_over_animation"])
+            if (currentAnimation != config.pointerOverAnimation)
             {
-                currentAnimation = (*_game->lua_state)["config"]["pointer_over_animation"];
+                currentAnimation = config.pointerOverAnimation;
                 playAnimation(0, currentAnimation, true);
                 this->setSkin("active");
             }
         }
         else
         {
-            if (currentAnimation != (*_game->lua_state)["config"]["pointer_idle_animation"])
+            if (currentAnimation != config.pointerIdleAnimation)
             {
-                currentAnimation = (*_game->lua_state)["config"]["pointer_idle_animation"];
+                currentAnimation = config.pointerIdleAnimation;
                 playAnimation(0, currentAnimation, true);
                 this->setSkin("inactive");
             }
@@ -124,7 +114,8 @@ bool Pointer::step(bool)
 
         last_mouse_pose = mouse_pose;
 
-        skeleton->step();
+        stepSkeleton();
+        markDepthDirty();
     }
 
     fade_out -= 0.03f;
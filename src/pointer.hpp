@@ -41,6 +41,9 @@ public:
 
     std::vector<std::shared_ptr<SpineObject>> attachedObjects;
 
+    /// Set by --benchmark, so that moving the real mouse doesn't change the seeded run
+    bool ignoreMouse = false;
+
 private:
     bool primaryAlreadyHandled = false;
     bool secondaryAlreadyHandled = false;
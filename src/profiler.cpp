@@ -0,0 +1,114 @@
+#include "profiler.hpp"
+
+#ifdef ALPACA_PROFILER
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+
+Profiler::Zone::Zone(const char* name) : name(name), start(Clock::now()) {
+}
+
+Profiler::Zone::~Zone() {
+	Profiler::handle().add(name, start, Clock::now());
+}
+
+Profiler::Profiler() : epoch(Clock::now()) {
+	const auto screensize = jngl::getScreenSize();
+	text.setPos(jngl::Vec2(screensize.x / 2 - 340, -screensize.y / 2 + 10));
+}
+
+void Profiler::add(const char* name, const Clock::time_point start, const Clock::time_point end) {
+	// Only a handful of zones, a linear search is faster than hashing. The same literal might have
+	// different addresses in different translation units.
+	auto it = std::find_if(zones.begin(), zones.end(), [name](const ZoneStats& zone) {
+		return zone.name == name || std::strcmp(zone.name, name) == 0;
+	});
+	if (it == zones.end()) {
+		it = zones.insert(zones.end(), ZoneStats{ name });
+	}
+	it->current += std::chrono::duration<float, std::micro>(end - start).count();
+	if (captureFrames > 0) {
+		trace.push_back(TraceEvent{ name, start, end });
+	}
+}
+
+void Profiler::beginFrame() {
+	for (auto& zone : zones) {
+		zone.history[frame % HISTORY] = zone.current;
+		zone.current = 0;
+	}
+	++frame;
+	if (captureFrames > 0 && --captureFrames == 0) {
+		writeTrace();
+		trace.clear();
+	}
+}
+
+void Profiler::step() {
+	if (jngl::keyPressed(jngl::key::F7)) {
+		visible = !visible;
+	}
+	if (jngl::keyPressed(jngl::key::F8) && captureFrames == 0) {
+		captureTrace(300, "alpaca-trace.json");
+	}
+}
+
+void Profiler::captureTrace(const int frames, std::filesystem::path path) {
+	trace.clear();
+	captureFrames = frames;
+	capturePath = std::move(path);
+}
+
+void Profiler::writeTrace() const {
+	std::ofstream file(capturePath);
+	file << "{\"traceEvents\":[";
+	bool first = true;
+	for (const auto& event : trace) {
+		using std::chrono::duration;
+		file << (first ? "\n" : ",\n")
+		     << std::format(R"({{"name":"{}","ph":"X","pid":1,"tid":1,"ts":{:.3f},"dur":{:.3f}}})",
+		                    event.name,
+		                    duration<double, std::micro>(event.start - epoch).count(),
+		                    duration<double, std::micro>(event.end - event.start).count());
+		first = false;
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	jngl::debug("Wrote {} profiler zones to {}", trace.size(), capturePath.string());
+}
+
+void Profiler::setFont(const std::string& fontFile) {
+	text.setFont(jngl::OutlinedFont(fontFile, 12, 9.f).bake(0x000000ff_rgba, 0xccccccff_rgba));
+}
+
+void Profiler::draw() const {
+	if (!visible) {
+		return;
+	}
+	// Sorting the history every frame would show up in the profile itself
+	if (textFrame + 30 <= frame || textFrame == 0) {
+		textFrame = frame;
+		const size_t count = std::min(frame, HISTORY);
+		std::string lines = std::format("{:<16}{:>10}{:>10}\n", "zone [us]", "avg", "p99");
+		std::array<float, HISTORY> sorted{};
+		for (const auto& zone : zones) {
+			std::copy_n(zone.history.begin(), count, sorted.begin());
+			float sum = 0;
+			for (size_t i = 0; i < count; ++i) {
+				sum += sorted[i];
+			}
+			const size_t p99 = count == 0 ? 0 : (count * 99) / 100;
+			std::nth_element(sorted.begin(), sorted.begin() + p99, sorted.begin() + count);
+			lines += std::format("{:<16}{:>10.0f}{:>10.0f}\n", zone.name,
+			                     count == 0 ? 0.f : sum / count, sorted[p99]);
+		}
+		if (captureFrames > 0) {
+			lines += std::format("capturing trace, {} frames left\n", captureFrames);
+		}
+		text.setText(lines);
+	}
+	text.draw();
+}
+
+#endif
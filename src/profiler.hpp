@@ -0,0 +1,86 @@
+#pragma once
+
+/// ALPACA_PROFILE_ZONE("name"); times the rest of the enclosing scope. The name has to be a string
+/// literal. Without -DALPACA_PROFILER=ON the macro expands to nothing. Zones must only be used on
+/// the main thread.
+#ifdef ALPACA_PROFILER
+
+#include <jngl.hpp>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+#define ALPACA_PROFILE_CONCAT_(a, b) a##b
+#define ALPACA_PROFILE_CONCAT(a, b) ALPACA_PROFILE_CONCAT_(a, b)
+#define ALPACA_PROFILE_ZONE(name)                                                                  \
+	const Profiler::Zone ALPACA_PROFILE_CONCAT(alpacaProfileZone, __LINE__)(name)
+
+/// Sums up the time spent in each zone per frame and shows the average and the 99th percentile of
+/// the last frames. F7 toggles the overlay, F8 writes the next frames to a Chrome trace file
+/// (chrome://tracing or ui.perfetto.dev).
+class Profiler : public jngl::Singleton<Profiler> {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	class Zone {
+	public:
+		explicit Zone(const char* name);
+		~Zone();
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+	private:
+		const char* name;
+		Clock::time_point start;
+	};
+
+	Profiler();
+
+	/// Called at the start of Game::step, closes the statistics of the last frame
+	void beginFrame();
+
+	/// Handles the F7 and F8 keys
+	void step();
+
+	void draw() const;
+	void setFont(const std::string& fontFile);
+
+	/// Records every zone of the next frames and writes them to path afterwards
+	void captureTrace(int frames, std::filesystem::path path);
+
+private:
+	void add(const char* name, Clock::time_point start, Clock::time_point end);
+	void writeTrace() const;
+
+	static constexpr size_t HISTORY = 240;
+	struct ZoneStats {
+		const char* name;
+		/// Microseconds spent in this zone in each of the last HISTORY frames, a ring buffer
+		std::array<float, HISTORY> history{};
+		float current = 0;
+	};
+	std::vector<ZoneStats> zones;
+	size_t frame = 0;
+
+	struct TraceEvent {
+		const char* name;
+		Clock::time_point start;
+		Clock::time_point end;
+	};
+	std::vector<TraceEvent> trace;
+	int captureFrames = 0;
+	std::filesystem::path capturePath;
+	Clock::time_point epoch;
+
+	bool visible = true;
+	mutable jngl::Text text;
+	mutable size_t textFrame = 0;
+};
+
+#else
+
+#define ALPACA_PROFILE_ZONE(name) static_cast<void>(0)
+
+#endif
@@ -0,0 +1,72 @@
+#include "render_queue.hpp"
+
+void RenderQueue::begin() {
+	assert(batchCount == 0);
+	recording = enabled;
+	stats = {};
+}
+
+void RenderQueue::end() {
+	flush();
+	recording = false;
+}
+
+bool RenderQueue::isRecording() const {
+	return recording;
+}
+
+void RenderQueue::flush() {
+	// The vertices are in the coordinate system of the identity matrix. drawMesh scales them by
+	// jngl::getScaleFactor() which is already accounted for in submit().
+	const jngl::Mat3 identity;
+	for (size_t i = 0; i < batchCount; ++i) {
+		Batch& batch = batches[i];
+		jngl::setSpriteColor(batch.color[0], batch.color[1], batch.color[2], batch.color[3]);
+		batch.texture->drawMesh(identity, batch.vertices, batch.shader);
+		batch.vertices.clear();
+		++stats.drawCalls;
+	}
+	if (batchCount > 0) {
+		jngl::setSpriteColor(255, 255, 255, 255);
+	}
+	batchCount = 0;
+}
+
+void RenderQueue::submit(const jngl::Sprite& texture, const jngl::ShaderProgram* shader,
+                         const std::array<uint8_t, 4> color, const spine::BlendMode blendMode,
+                         const jngl::Mat3& modelview, const std::vector<jngl::Vertex>& vertices) {
+	if (!recording) {
+		jngl::setSpriteColor(color[0], color[1], color[2], color[3]);
+		texture.drawMesh(modelview, vertices, shader);
+		return;
+	}
+	++stats.commands;
+
+	Batch* batch = batchCount > 0 ? &batches[batchCount - 1] : nullptr;
+	if (!batch || batch->texture != &texture || batch->shader != shader || batch->color != color ||
+	    batch->blendMode != blendMode) {
+		if (batchCount == batches.size()) {
+			batches.emplace_back();
+		}
+		batch = &batches[batchCount++];
+		batch->texture = &texture;
+		batch->shader = shader;
+		batch->color = color;
+		batch->blendMode = blendMode;
+	}
+
+	// Apply the object's modelview on the CPU so that meshes of different objects can be merged.
+	// The translation of jngl::Mat3 is in actual pixels, the vertices get scaled by drawMesh.
+	const float* m = modelview.data;
+	const auto scaleFactor = static_cast<float>(jngl::getScaleFactor());
+	const float translateX = m[6] / scaleFactor;
+	const float translateY = m[7] / scaleFactor;
+	for (const auto& vertex : vertices) {
+		batch->vertices.push_back(jngl::Vertex{
+		    .x = m[0] * vertex.x + m[3] * vertex.y + translateX,
+		    .y = m[1] * vertex.x + m[4] * vertex.y + translateY,
+		    .u = vertex.u,
+		    .v = vertex.v,
+		});
+	}
+}
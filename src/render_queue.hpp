@@ -0,0 +1,53 @@
+#pragma once
+
+#include <jngl.hpp>
+#include <spine/spine.h>
+
+#include <array>
+
+/// Collects the meshes of all objects drawn by Game::draw and merges adjacent ones which share
+/// texture, shader, colour and blend mode into one drawMesh call. Commands are submitted in z order
+/// and never reordered.
+class RenderQueue : public jngl::Singleton<RenderQueue> {
+public:
+	/// From now on submit() queues instead of drawing immediately
+	void begin();
+
+	/// Draws everything that has been queued and stops recording
+	void end();
+
+	bool isRecording() const;
+
+	/// Draws everything queued so far. Has to be called before drawing anything directly (lines,
+	/// text, framebuffers, ...) while recording.
+	void flush();
+
+	/// Draws immediately if the queue isn't recording
+	void submit(const jngl::Sprite& texture, const jngl::ShaderProgram* shader,
+	            std::array<uint8_t, 4> color, spine::BlendMode blendMode,
+	            const jngl::Mat3& modelview, const std::vector<jngl::Vertex>& vertices);
+
+	/// Can be switched off in debug builds to compare the results
+	bool enabled = true;
+
+	struct Stats {
+		int commands = 0;
+		int drawCalls = 0;
+	};
+	/// Reset by begin()
+	Stats stats;
+
+private:
+	struct Batch {
+		const jngl::Sprite* texture = nullptr;
+		const jngl::ShaderProgram* shader = nullptr;
+		std::array<uint8_t, 4> color{};
+		spine::BlendMode blendMode = spine::BlendMode_Normal;
+		/// Already transformed by the modelview of the submitting object
+		std::vector<jngl::Vertex> vertices;
+	};
+	/// Batches are reused between frames to keep the capacity of their vertex buffers
+	std::vector<Batch> batches;
+	size_t batchCount = 0;
+	bool recording = false;
+};
@@ -4,13 +4,31 @@
 #include "interactable_object.hpp"
 #include "game.hpp"
 #include "player.hpp"
+#include "scene_preloader.hpp"
+
+namespace {
+std::unique_ptr<jngl::ImageData> loadImage(const std::string &file, ScenePreloader *preloaded)
+{
+    if (preloaded)
+    {
+        if (auto image = preloaded->takeImage(file))
+        {
+            return image;
+        }
+    }
+    return jngl::ImageData::load(file);
+}
+} // namespace
 
 LoadException::LoadException(const char *details)
     : std::runtime_error(details)
 {
 }
 
-Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game) : fileName(fileName), json(YAML::Load(jngl::readAsset("scenes/" + fileName + ".json").str())), game(game)
+Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game, ScenePreloader *preloaded)
+    : fileName(fileName),
+      json(preloaded && preloaded->getSceneName() == fileName ? preloaded->getJson() : YAML::Load(jngl::readAsset("scenes/" + fileName + ".json").str())),
+      game(game)
 {
 
     std::string scene = fileName;
@@ -100,7 +118,7 @@ Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game) : f
     {
         background = std::make_shared<Background>(game, (*game->lua_state)["scenes"][scene]["background"]["spine"]);
         background->setPosition(jngl::Vec2(0, 0));
-        background->layer = 0;
+        background->setLayer(0);
         if ((*game->lua_state)["scenes"][scene]["background"]["skin"].valid())
         {
             std::vector<std::string> const skins = (*game->lua_state)["scenes"][scene]["background"]["skin"].get<sol::as_table_t<std::vector<std::string>>>();
@@ -120,7 +138,7 @@ Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game) : f
     {
         try {
 #endif
-    zBufferMap = jngl::ImageData::load((*game->lua_state)["scenes"][scene]["zBufferMap"]);
+    zBufferMap = loadImage((*game->lua_state)["scenes"][scene]["zBufferMap"], preloaded);
 
 #ifndef NDEBUG
         } catch (std::exception &e) {
@@ -162,7 +180,7 @@ Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game) : f
         background = std::make_shared<Background>(game, spine);
         background->setPosition(jngl::Vec2(0, 0));
         background->playAnimation(0, animation, true);
-        background->layer = 0;
+        background->setLayer(0);
         if (json["background"]["skin"])
         {
             std::vector<std::string> skins = {};
@@ -175,7 +193,7 @@ Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game) : f
 
         if (json["zBufferMap"].IsDefined() && !json["zBufferMap"].IsNull())
         {
-            zBufferMap = jngl::ImageData::load(json["zBufferMap"].as<std::string>());
+            zBufferMap = loadImage(json["zBufferMap"].as<std::string>(), preloaded);
             (*game->lua_state)["scenes"][scene]["zBufferMap"] = json["zBufferMap"].as<std::string>();
 #ifndef NDEBUG
             background->sprite = std::make_unique<jngl::Sprite>(*zBufferMap, jngl::getScaleFactor());
@@ -226,9 +244,8 @@ Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game) : f
                 game->player->setSkin((*game->lua_state)["config"]["player_default_skin"]);
                 game->player->playAnimation(0, animation, true);
 
-                game->player->toLuaState();
-
                 game->add(game->player);
+                game->player->toLuaState();
             }
         }
         else
@@ -241,15 +258,13 @@ Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game) : f
                 game->player->setVisible((*game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["visible"]);
                 game->player->setMaxSpeed((*game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["max_speed"]);
                 float const layer = (*game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["layer"];
-                game->player->layer = static_cast<int>(layer);
+                game->player->setLayer(static_cast<int>(layer));
                 game->player->setSkins((*game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["skin"].get<sol::as_table_t<std::vector<std::string>>>());
                 game->player->setCrossScene((*game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["cross_scene"]);
                 if ((*game->lua_state)["game"].valid() && (*game->lua_state)["game"]["interruptible"].valid())
                 {
                     game->player->interruptible = (*game->lua_state)["game"]["interruptible"];
                 }
-                (*game->lua_state)["scenes"]["cross_scene"]["items"]["player"]["object"] = std::static_pointer_cast<SpineObject>(game->player);
-
                 game->add(game->player);
             }
         }
@@ -287,8 +302,6 @@ Scene::Scene(const std::string &fileName, const std::shared_ptr<Game> &game) : f
             interactable->setCrossScene(true);
             interactable->setLuaIndex(id);
 
-            (*game->lua_state)["inventory_items"][id]["object"] = std::static_pointer_cast<SpineObject>(interactable);
-
             if ((*game->lua_state)["inventory_items"][id]["skin"].valid())
             {
                 std::vector<std::string> const skins = (*game->lua_state)["inventory_items"][id]["skin"].get<sol::as_table_t<std::vector<std::string>>>();
@@ -341,7 +354,7 @@ void Scene::createObjectJSON(const YAML::Node &object) {
         bool const visible = (object)["visible"].as<bool>(true);
 
         auto interactable = createObject(spine_file, id, scale);
-        interactable->layer = layer;
+        interactable->setLayer(layer);
         if (animation.empty()) {
             animation = (*_game->lua_state)["config"]["spine_default_animation"];
         }
@@ -354,6 +367,7 @@ void Scene::createObjectJSON(const YAML::Node &object) {
         interactable->setShader(shader);
         interactable->setVisible(visible);
 
+        _game->add(interactable);
         interactable->toLuaState();
 
         if ((object)["skin"]) {
@@ -363,7 +377,6 @@ void Scene::createObjectJSON(const YAML::Node &object) {
 
             interactable->setSkins(skins);
         }
-        _game->add(interactable);
     }
 }
 
@@ -391,7 +404,7 @@ void Scene::createObjectLua(std::string id, std::string scene) {
 
             interactable->setPosition(jngl::Vec2(x, y));
             interactable->setVisible(visible);
-            interactable->layer = static_cast<int>(layer);
+            interactable->setLayer(static_cast<int>(layer));
             interactable->setCrossScene(cross_scene);
             interactable->abs_position = abs_position;
             if (!shader.empty()) {
@@ -403,8 +416,6 @@ void Scene::createObjectLua(std::string id, std::string scene) {
             }
             interactable->playAnimation(0, animation, true);
 
-            (*_game->lua_state)["scenes"][scene]["items"][id]["object"] = std::static_pointer_cast<SpineObject>(interactable);
-
             if ((*_game->lua_state)["scenes"][scene]["items"][id]["skin"].valid()) {
                 std::vector<std::string> const skin = (*_game->lua_state)["scenes"][scene]["items"][id]["skin"].get<sol::as_table_t<std::vector<std::string>>>();
 
@@ -6,6 +6,7 @@
 
 class Game;
 class InteractableObject;
+class ScenePreloader;
 
 class LoadException : public std::runtime_error
 {
@@ -20,7 +21,8 @@ class SceneExit
 class Scene
 {
 public:
-    explicit Scene(const std::string &fileName, const std::shared_ptr<Game> &game);
+    /// preloaded: assets loaded in the background by Game::loadSceneWithFade, may be nullptr
+    explicit Scene(const std::string &fileName, const std::shared_ptr<Game> &game, ScenePreloader *preloaded = nullptr);
 
     void playMusic();
     std::shared_ptr<InteractableObject> createObject(const std::string &spine_file, const std::string &id, float scale);
@@ -0,0 +1,212 @@
+#include "scene_generator.hpp"
+
+#include "command_line.hpp"
+#include "skeleton_drawable.hpp"
+#include "spine_data_cache.hpp"
+
+#include <jngl.hpp>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <set>
+
+namespace {
+
+struct Project {
+	std::string name;
+	std::string animation;
+	/// Without the default skin, empty if that's the only one
+	std::vector<std::string> skins;
+};
+
+/// Folders of the data directory which contain a Spine export of the same name
+std::vector<std::string> findSpineProjects() {
+	std::vector<std::string> result;
+	for (const auto& entry : std::filesystem::directory_iterator(".")) {
+		if (!entry.is_directory()) {
+			continue;
+		}
+		const auto name = entry.path().filename().string();
+		const auto base = entry.path() / name;
+		if (std::filesystem::exists(base.string() + ".atlas") &&
+		    (std::filesystem::exists(base.string() + ".skel") ||
+		     std::filesystem::exists(base.string() + ".json"))) {
+			result.push_back(name);
+		}
+	}
+	std::sort(result.begin(), result.end()); // directory order differs between file systems
+	return result;
+}
+
+/// Backgrounds and the pointer wouldn't make sense as items
+std::set<std::string> excludedProjects(const YAML::Node& config) {
+	std::set<std::string> result{ config["pointer"].as<std::string>() };
+	for (const auto& entry : std::filesystem::directory_iterator("scenes")) {
+		if (entry.path().extension() != ".json") {
+			continue;
+		}
+		const auto json = YAML::Load(jngl::readAsset("scenes/" + entry.path().filename().string()).str());
+		if (json["background"]["spine"]) {
+			result.insert(json["background"]["spine"].as<std::string>());
+		}
+	}
+	return result;
+}
+
+struct Area {
+	float left, top, right, bottom;
+};
+
+/// Bounding rectangle of the walkable_area boxes of the background in its setup pose
+std::optional<Area> walkableArea(const std::string& background) {
+	const auto data = SpineDataCache::handle().get(background);
+	if (!data) {
+		return std::nullopt;
+	}
+	SkeletonDrawable skeleton(*data->skeletonData, data->animationStateData.get());
+	skeleton.step();
+	spine::SkeletonBounds bounds;
+	bounds.update(*skeleton.skeleton, true);
+
+	Area area{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+		       std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	bool found = false;
+	auto& boundingBoxes = bounds.getBoundingBoxes();
+	auto& polygons = bounds.getPolygons();
+	for (size_t i = 0; i < boundingBoxes.size(); ++i) {
+		if (data->boundingBoxKinds.get(*boundingBoxes[i]) != BoundingBoxKind::Walkable) {
+			continue;
+		}
+		const auto& vertices = polygons[i]->_vertices;
+		for (int j = 0; j + 1 < polygons[i]->_count; j += 2) {
+			area.left = std::min(area.left, vertices[j]);
+			area.right = std::max(area.right, vertices[j]);
+			area.top = std::min(area.top, vertices[j + 1]);
+			area.bottom = std::max(area.bottom, vertices[j + 1]);
+			found = true;
+		}
+	}
+	return found ? std::optional(area) : std::nullopt;
+}
+
+} // namespace
+
+std::optional<SceneGenerator::Options>
+SceneGenerator::parseArgs(const std::vector<std::string>& args) {
+	std::optional<Options> options;
+	for (size_t i = 0; i < args.size(); ++i) {
+		if (args[i] == "--generate-scene") {
+			if (!options) {
+				options.emplace();
+			}
+			options->name = argumentValue(args, i);
+		}
+	}
+	if (!options) {
+		return std::nullopt;
+	}
+	for (size_t i = 0; i < args.size(); ++i) {
+		if (args[i] == "--objects") {
+			options->objects = std::max(0, numericArgument<int>(args, i));
+		} else if (args[i] == "--seed") {
+			options->seed = numericArgument<uint32_t>(args, i);
+		} else if (args[i] == "--obstacles") {
+			options->obstacles = std::clamp(numericArgument<double>(args, i), 0.0, 1.0);
+		} else if (args[i] == "--template") {
+			options->templateScene = argumentValue(args, i);
+		}
+	}
+	return options;
+}
+
+void SceneGenerator::generate(const Options& options, const YAML::Node& config) {
+	const auto templateScene = options.templateScene.empty()
+	                               ? config["start_scene"].as<std::string>()
+	                               : options.templateScene;
+	YAML::Node json = YAML::Load(jngl::readAsset("scenes/" + templateScene + ".json").str());
+	json.remove("items");
+	json.remove("hash");
+
+	const auto defaultAnimation = config["spine_default_animation"].as<std::string>();
+	const auto excluded = excludedProjects(config);
+	std::vector<Project> withObstacles;
+	std::vector<Project> withoutObstacles;
+	for (const auto& name : findSpineProjects()) {
+		if (excluded.contains(name)) {
+			continue;
+		}
+		const auto data = SpineDataCache::handle().get(name);
+		if (!data || data->skeletonData->getAnimations().size() == 0) {
+			continue;
+		}
+		Project project{ name, defaultAnimation, {} };
+		if (!data->skeletonData->findAnimation(defaultAnimation.c_str())) {
+			project.animation = data->skeletonData->getAnimations()[0]->getName().buffer();
+		}
+		auto& skins = data->skeletonData->getSkins();
+		for (size_t i = 0; i < skins.size(); ++i) {
+			if (skins[i] != data->skeletonData->getDefaultSkin()) {
+				project.skins.emplace_back(skins[i]->getName().buffer());
+			}
+		}
+		(data->boundingBoxKinds.has(BoundingBoxKind::NonWalkable) ? withObstacles
+		                                                           : withoutObstacles)
+		    .push_back(std::move(project));
+	}
+	if (withObstacles.empty() && withoutObstacles.empty()) {
+		jngl::error("No Spine projects to generate scene {} from", options.name);
+		return;
+	}
+
+	const jngl::Vec2 screensize = jngl::getScreenSize();
+	// The screen is centred around (0, 0)
+	const auto area = walkableArea(json["background"]["spine"].as<std::string>(""))
+	                      .value_or(Area{ static_cast<float>(-screensize.x / 2),
+	                                      static_cast<float>(-screensize.y / 2),
+	                                      static_cast<float>(screensize.x / 2),
+	                                      static_cast<float>(screensize.y / 2) });
+
+	std::mt19937 random(options.seed);
+	std::uniform_real_distribution<float> x(area.left, area.right);
+	std::uniform_real_distribution<float> y(area.top, area.bottom);
+	// SpineDataCache parses a project once per scale, a continuous scale would load it per object
+	constexpr std::array SCALES{ 0.2f, 0.3f, 0.4f, 0.5f };
+	std::uniform_int_distribution<size_t> scale(0, SCALES.size() - 1);
+	std::uniform_int_distribution<int> layer(1, 3);
+	std::bernoulli_distribution obstacle(options.obstacles);
+	for (int i = 0; i < options.objects; ++i) {
+		const auto& projects =
+		    (obstacle(random) && !withObstacles.empty()) || withoutObstacles.empty()
+		        ? withObstacles
+		        : withoutObstacles;
+		const auto& project =
+		    projects[std::uniform_int_distribution<size_t>(0, projects.size() - 1)(random)];
+
+		YAML::Node item;
+		item["spine"] = project.name;
+		item["id"] = project.name + "_" + std::to_string(i);
+		item["x"] = std::to_string(x(random));
+		item["y"] = std::to_string(y(random));
+		item["scale"] = std::to_string(SCALES[scale(random)]);
+		item["layer"] = layer(random);
+		item["animation"] = project.animation;
+		if (!project.skins.empty()) {
+			item["skin"] =
+			    project.skins[std::uniform_int_distribution<size_t>(0, project.skins.size() - 1)(random)];
+		}
+		json["items"].push_back(item);
+	}
+
+	YAML::Emitter emitter;
+	emitter << YAML::DoubleQuoted << YAML::LowerNull << json;
+	emitter.SetIndent(4);
+	emitter.SetMapFormat(YAML::Block);
+	std::ofstream fout("scenes/" + options.name + ".json");
+	fout << emitter.c_str();
+	jngl::debug("Generated scenes/{}.json with {} items ({} projects with obstacles, {} without)",
+	            options.name, options.objects, withObstacles.size(), withoutObstacles.size());
+}
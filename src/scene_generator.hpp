@@ -0,0 +1,32 @@
+#pragma once
+
+#include <yaml-cpp/yaml.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+/// pac --generate-scene <name> [--objects N] [--seed N] [--obstacles fraction] [--template scene]
+///
+/// Writes scenes/<name>.json with the background of the template scene (the start scene by
+/// default) and N items of the Spine projects in the data folder, for measuring how the engine
+/// scales with the number of objects. Positions, layers, scales and skins are random. Obstacles
+/// and clickable regions come from the bounding boxes of the projects: the given fraction of the
+/// items uses projects with non_walkable_area boxes, the rest the other ones.
+class SceneGenerator {
+public:
+	struct Options {
+		std::string name;
+		int objects = 100;
+		uint32_t seed = 0;
+		double obstacles = 0.2;
+		std::string templateScene;
+	};
+
+	/// Returns nullopt if there's no --generate-scene in args, throws std::invalid_argument if an
+	/// option has no or a malformed value
+	static std::optional<Options> parseArgs(const std::vector<std::string>& args);
+
+	/// Has to be called after the window has been created, since it loads the Spine projects
+	static void generate(const Options&, const YAML::Node& config);
+};
@@ -0,0 +1,119 @@
+#include "scene_preloader.hpp"
+
+#include "spine_data_cache.hpp"
+
+ScenePreloader::ScenePreloader(std::string sceneName, YAML::Node json, sol::state& lua)
+: sceneName(std::move(sceneName)), json(std::move(json)) {
+	std::vector<std::pair<std::string, float>> spineFiles;
+	std::vector<std::string> imageFiles;
+
+	// Scene has been visited before, it will be created from the Lua state
+	if (lua["scenes"].valid() && lua["scenes"][this->sceneName].valid()) {
+		sol::table const scene = lua["scenes"][this->sceneName];
+		if (scene["background"].valid() && scene["background"]["spine"].valid()) {
+			spineFiles.emplace_back(scene["background"]["spine"].get<std::string>(), 1.f);
+		}
+		if (scene["zBufferMap"].valid()) {
+			imageFiles.emplace_back(scene["zBufferMap"].get<std::string>());
+		}
+		if (scene["items"].valid()) {
+			sol::table const items = scene["items"];
+			for (const auto& [key, item] : items) {
+				if (item.is<sol::table>()) {
+					sol::table const table = item.as<sol::table>();
+					if (table["spine"].valid()) {
+						spineFiles.emplace_back(table["spine"].get<std::string>(),
+						                        table["scale"].get_or(1.f));
+					}
+				}
+			}
+		}
+	}
+
+	if (this->json.IsMap()) {
+		const auto& background = this->json["background"];
+		if (background.IsDefined() && !background.IsNull() && background["spine"]) {
+			spineFiles.emplace_back(background["spine"].as<std::string>(), 1.f);
+		}
+		const auto& zBufferMap = this->json["zBufferMap"];
+		if (zBufferMap.IsDefined() && !zBufferMap.IsNull()) {
+			imageFiles.emplace_back(zBufferMap.as<std::string>());
+		}
+		const auto& items = this->json["items"];
+		if (items.IsDefined() && items.IsSequence()) {
+			for (const auto& item : items) {
+				if (item["spine"]) {
+					spineFiles.emplace_back(item["spine"].as<std::string>(),
+					                        item["scale"].as<float>(1));
+				}
+			}
+		}
+	}
+
+	std::ranges::sort(spineFiles);
+	spineFiles.erase(std::ranges::unique(spineFiles).begin(), spineFiles.end());
+	std::ranges::sort(imageFiles);
+	imageFiles.erase(std::ranges::unique(imageFiles).begin(), imageFiles.end());
+
+#ifdef __EMSCRIPTEN__
+	// No threads without -pthread, load when the scene is needed
+	const auto policy = std::launch::deferred;
+#else
+	const auto policy = std::launch::async;
+#endif
+	worker = std::async(policy, [this, spineFiles = std::move(spineFiles),
+	                             imageFiles = std::move(imageFiles)]() {
+		load(spineFiles, imageFiles);
+	});
+}
+
+ScenePreloader::~ScenePreloader() {
+	if (worker.valid()) {
+		worker.wait();
+	}
+}
+
+const std::string& ScenePreloader::getSceneName() const {
+	return sceneName;
+}
+
+const YAML::Node& ScenePreloader::getJson() const {
+	return json;
+}
+
+void ScenePreloader::wait() {
+	if (!worker.valid()) {
+		return;
+	}
+	try {
+		worker.get();
+	} catch (std::exception& e) {
+		jngl::error("Preloading scene {} failed: {}", sceneName, e.what());
+	}
+}
+
+std::unique_ptr<jngl::ImageData> ScenePreloader::takeImage(const std::string& file) {
+	auto it = images.find(file);
+	if (it == images.end()) {
+		return nullptr;
+	}
+	auto image = std::move(it->second);
+	images.erase(it);
+	return image;
+}
+
+void ScenePreloader::load(const std::vector<std::pair<std::string, float>>& spineFiles,
+                          const std::vector<std::string>& imageFiles) {
+	for (const auto& [file, scale] : spineFiles) {
+		if (auto data = SpineDataCache::handle().get(file, scale)) {
+			spineData.emplace_back(std::move(data));
+		}
+	}
+	for (const auto& file : imageFiles) {
+		try {
+			images.emplace(file, jngl::ImageData::load(file));
+		} catch (std::exception& e) {
+			jngl::error("Failed to preload {}: {}", file, e.what());
+		}
+	}
+}
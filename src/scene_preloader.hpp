@@ -0,0 +1,41 @@
+#pragma once
+
+#include <jngl.hpp>
+#include <sol/sol.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <future>
+#include <map>
+
+struct SpineData;
+
+/// Loads the assets of the next scene on a worker thread while SceneFade is fading out. Only GPU
+/// uploads and object creation are left for the main thread.
+class ScenePreloader {
+public:
+	/// Has to be called from the main thread, since the Spine files of a scene that was already
+	/// visited are looked up in the Lua state.
+	ScenePreloader(std::string sceneName, YAML::Node json, sol::state& lua);
+	~ScenePreloader();
+
+	const std::string& getSceneName() const;
+	const YAML::Node& getJson() const;
+
+	/// Blocks until the worker thread is done
+	void wait();
+
+	/// Returns nullptr if the image hasn't been preloaded
+	std::unique_ptr<jngl::ImageData> takeImage(const std::string& file);
+
+private:
+	void load(const std::vector<std::pair<std::string, float>>& spineFiles,
+	          const std::vector<std::string>& imageFiles);
+
+	std::string sceneName;
+	YAML::Node json;
+	std::future<void> worker;
+
+	/// Keeps the SpineDataCache entries alive until the scene has been created
+	std::vector<std::shared_ptr<SpineData>> spineData;
+	std::map<std::string, std::unique_ptr<jngl::ImageData>> images;
+};
@@ -0,0 +1,134 @@
+#include "script_cache.hpp"
+
+#include "spine_data_cache.hpp"
+
+#include <spine/spine.h>
+
+#include <cstring>
+#include <string_view>
+
+void ScriptCache::useState(sol::state& lua) {
+	if (lua.lua_state() == state) {
+		return;
+	}
+	// The old state is gone already, unreferencing the functions there would crash
+	for (auto& [_, script] : functions) {
+		script.function.abandon();
+	}
+	for (auto& [_, project] : events) {
+		for (auto& entry : project.actions) {
+			entry.second.code.abandon();
+		}
+	}
+	functions.clear();
+	events.clear();
+	state = lua.lua_state();
+}
+
+sol::protected_function* ScriptCache::get(sol::state& lua, const std::string& name) {
+	auto* script = load(lua, name);
+	return script ? &script->function : nullptr;
+}
+
+ScriptCache::Script* ScriptCache::load(sol::state& lua, const std::string& name) {
+	useState(lua);
+	if (const auto it = functions.find(name); it != functions.end()) {
+		return &it->second;
+	}
+
+	std::string file = "scripts/" + name + ".luac";
+	std::stringstream source = jngl::readAsset(file);
+	if (!source) {
+		file = "scripts/" + name + ".lua";
+		source = jngl::readAsset(file);
+	}
+	if (!source) {
+		jngl::error("Can not load lua script " + file);
+		return nullptr;
+	}
+	// Same chunk name as before, so that error messages and the print hyperlinks point to the file
+	sol::load_result chunk = lua.load(source.str(), "@" + file, sol::load_mode::any);
+	if (!chunk.valid()) {
+		const sol::error err = chunk;
+		jngl::error(err.what());
+		return nullptr;
+	}
+	return &functions.emplace(name, Script{ chunk.get<sol::protected_function>(), std::move(file) })
+	            .first->second;
+}
+
+void ScriptCache::run(sol::state& lua, const std::string& name) {
+	const auto* cached = load(lua, name);
+	if (!cached) {
+		return;
+	}
+	jngl::log("lua", cached->file);
+	// A copy, since the script might clear the cache, e.g. by calling LoadGame
+	const sol::protected_function function = cached->function;
+	auto result = function();
+	if (!result.valid()) {
+		const sol::error err = result;
+		jngl::error(err.what());
+	}
+}
+
+const ScriptCache::EventAction& ScriptCache::getEvent(sol::state& lua,
+                                                     const std::shared_ptr<SpineData>& project,
+                                                     const spine::EventData& data) {
+	useState(lua);
+	auto& projectEvents = events[project.get()];
+	if (projectEvents.project.lock() != project) {
+		// The address of a freed project has been reused
+		projectEvents = ProjectEvents{ project };
+	}
+	const auto [it, inserted] = projectEvents.actions.try_emplace(&data);
+	auto& action = it->second;
+	if (!inserted) {
+		return action; // also if loading or compiling failed, to not log that every time
+	}
+
+	// getString() and getAudioPath() aren't const, but don't change anything
+	auto& mutableData = const_cast<spine::EventData&>(data);
+	const char* audioPath = mutableData.getAudioPath().buffer();
+	const char* source = mutableData.getSetupPose().getString().buffer();
+	if (audioPath && *audioPath) {
+		try {
+			action.sound = std::make_shared<jngl::SoundFile>(std::string("audio/") + audioPath);
+			action.sound->load();
+		} catch (const std::runtime_error& err) {
+			jngl::error("Failed to load audio of Spine event {}: {}", data.getName().buffer(),
+			            err.what());
+		}
+	}
+	const size_t length = source ? std::strlen(source) : 0;
+	if (length > 4 && std::string_view(source).ends_with(".lua")) {
+		action.script = std::string(source, length - 4);
+	} else if (length > 0) {
+		sol::load_result chunk =
+		    lua.load(source, std::string("=event ") + data.getName().buffer());
+		if (chunk.valid()) {
+			action.code = chunk.get<sol::protected_function>();
+		} else {
+			const sol::error err = chunk;
+			jngl::error("Failed to compile script of Spine event {}: {}", data.getName().buffer(),
+			            err.what());
+		}
+	}
+	return action;
+}
+
+void ScriptCache::prepareEvents(sol::state& lua, const std::shared_ptr<SpineData>& project) {
+	auto& eventData = project->skeletonData->getEvents();
+	for (size_t i = 0; i < eventData.size(); ++i) {
+		getEvent(lua, project, *eventData[i]);
+	}
+}
+
+void ScriptCache::releaseUnused() {
+	std::erase_if(events, [](const auto& entry) { return entry.second.project.expired(); });
+}
+
+void ScriptCache::clear() {
+	functions.clear();
+	events.clear();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <jngl.hpp>
+#include <sol/sol.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace spine {
+class EventData;
+} // namespace spine
+struct SpineData;
+
+/// Compiled Lua scripts of the scripts folder, so that running an action again neither reads the
+/// file nor parses it. Prefers scripts/<name>.luac, which prepare_assets.py writes if COMPILE_LUA
+/// is set, over scripts/<name>.lua. Also prepares what Spine events do.
+class ScriptCache {
+public:
+	/// What a Spine event does when it fires (see SpineObject::dispatchEvents())
+	struct EventAction {
+		/// Loaded audio/<audio path>, nullptr if the event has none or it couldn't be loaded
+		std::shared_ptr<jngl::SoundFile> sound;
+		/// The string names a script file, e.g. "footstep.lua": the name to pass to
+		/// Game::runAction, i.e. "footstep"
+		std::string script;
+		/// Otherwise the string compiled as Lua code, invalid if there's none or it doesn't compile
+		sol::protected_function code;
+	};
+
+	/// Prepared on first use, so that repeated events neither load nor compile anything. data has
+	/// to belong to the skeleton data of project.
+	const EventAction& getEvent(sol::state&, const std::shared_ptr<SpineData>& project,
+	                            const spine::EventData& data);
+
+	/// Prepares all events of a Spine project, so that their sounds are loaded up front
+	void prepareEvents(sol::state&, const std::shared_ptr<SpineData>& project);
+
+	/// Drops the actions and sounds of Spine projects which have been freed, call after
+	/// SpineDataCache::releaseUnused()
+	void releaseUnused();
+
+	/// Loads and compiles the script on first use. Returns nullptr (and logs why) if it doesn't
+	/// exist or doesn't compile, in which case the next call tries again.
+	sol::protected_function* get(sol::state&, const std::string& name);
+
+	/// Runs the script and logs errors
+	void run(sol::state&, const std::string& name);
+
+	/// Has to be called before the Lua state is destroyed and when scripts changed on disk
+	void clear();
+
+private:
+	/// Drops everything if state isn't the state the cache has been filled for
+	void useState(sol::state&);
+
+	struct Script {
+		sol::protected_function function;
+		/// The file it has been loaded from, logged by run()
+		std::string file;
+	};
+	/// get(), but also returns the file
+	Script* load(sol::state&, const std::string& name);
+
+	/// The actions of the events of one Spine project
+	struct ProjectEvents {
+		/// Expired once the project has been freed, its EventData pointers are dangling then
+		std::weak_ptr<SpineData> project;
+		std::unordered_map<const spine::EventData*, EventAction> actions;
+	};
+
+	std::unordered_map<std::string, Script> functions;
+	std::unordered_map<const SpineData*, ProjectEvents> events;
+	/// The state the functions belong to
+	lua_State* state = nullptr;
+};
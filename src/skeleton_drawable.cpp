@@ -1,36 +1,39 @@
 #include "skeleton_drawable.hpp"
 #include "polylabel.hpp"
-
-#ifndef NDEBUG
-void pac_unload_file(const char* path);
-
-#endif
+#include "profiler.hpp"
+#include "render_queue.hpp"
 
 spine::SpineExtension* spine::getDefaultExtension() {
 	return new spine::DefaultSpineExtension();
 }
 
-void TextureLoader::load(spine::AtlasPage& page, const spine::String& path) {
-#ifndef NDEBUG
-    pac_unload_file(path.buffer());
-#endif
+AtlasTexture::AtlasTexture(std::unique_ptr<jngl::ImageData> imageData)
+: imageData(std::move(imageData)) {
+}
+
+jngl::Sprite& AtlasTexture::sprite() {
+	if (!uploaded) {
+		uploaded = std::make_unique<jngl::Sprite>(*imageData, jngl::getScaleFactor());
+		imageData.reset();
+	}
+	return *uploaded;
+}
 
-    auto texture = new jngl::Sprite(path.buffer());
-    // if (!texture->loadFromFile(path)) return;
+void TextureLoader::load(spine::AtlasPage& page, const spine::String& path) {
+	auto imageData = jngl::ImageData::load(path.buffer());
 
 	// TODO
 	// if (self->magFilter == SP_ATLAS_LINEAR) texture->setSmooth(true);
 	// if (self->uWrap == SP_ATLAS_REPEAT && self->vWrap == SP_ATLAS_REPEAT)
 	// texture->setRepeated(true);
 
-	page.texture = texture;
-	// Vector2u size = texture->getSize();
-	page.width = texture->getWidth();
-	page.height = texture->getHeight();
+	page.width = imageData->getWidth();
+	page.height = imageData->getHeight();
+	page.texture = new AtlasTexture(std::move(imageData));
 }
 
 void TextureLoader::unload(void* texture) {
-	delete (jngl::Sprite*)texture;
+	delete static_cast<AtlasTexture*>(texture);
 }
 
 namespace {
@@ -49,10 +52,12 @@ struct SpineExtension : spine::DefaultSpineExtension {
 } // namespace
 
 TextureLoader SkeletonDrawable::textureLoader;
+SkeletonDrawable::FrameStats SkeletonDrawable::frameStats;
+SkeletonDrawable::StepStats SkeletonDrawable::stepStats;
 
 SkeletonDrawable::SkeletonDrawable(spine::SkeletonData& skeletonData,
-                                   std::unique_ptr<spine::AnimationStateData> animationStateData)
-: timeScale(1), animationStateData(std::move(animationStateData)) {
+                                   spine::AnimationStateData* animationStateData)
+: timeScale(1) {
 	quadIndices.add(0);
 	quadIndices.add(1);
 	quadIndices.add(2);
@@ -62,22 +67,63 @@ SkeletonDrawable::SkeletonDrawable(spine::SkeletonData& skeletonData,
 	spine::Bone::setYDown(true);
 	skeleton = std::make_unique<spine::Skeleton>(skeletonData);
 
-	if (!this->animationStateData) {
-		this->animationStateData = std::make_unique<spine::AnimationStateData>(skeletonData);
+	if (!animationStateData) {
+		ownAnimationStateData = std::make_unique<spine::AnimationStateData>(skeletonData);
+		animationStateData = ownAnimationStateData.get();
 	}
 
-	state = std::make_unique<spine::AnimationState>(*this->animationStateData.get());
+	state = std::make_unique<spine::AnimationState>(*animationStateData);
 }
 
 SkeletonDrawable::~SkeletonDrawable() = default;
 
-void SkeletonDrawable::step() {
+bool SkeletonDrawable::step() {
+	if (sleeping) {
+		++stepStats.sleeping;
+		updateHotspots();
+		return false;
+	}
+	++stepStats.awake;
     const float deltaTime = 1.f / static_cast<float>(jngl::getStepsPerSecond());
 	state->update(deltaTime * timeScale);
 	state->apply(*skeleton);
 	skeleton->update(deltaTime * timeScale);
 	skeleton->updateWorldTransform(spine::Physics_Update);
 
+	if (!poseIsStatic()) {
+		staticSteps = 0;
+	} else if (++staticSteps >= static_cast<int>(jngl::getStepsPerSecond())) {
+		sleeping = true;
+	}
+
+	updateHotspots();
+	return true;
+}
+
+void SkeletonDrawable::wake() {
+	sleeping = false;
+	staticSteps = 0;
+}
+
+bool SkeletonDrawable::poseIsStatic() const {
+	auto& tracks = state->getTracks();
+	for (size_t i = 0; i < tracks.size(); ++i) {
+		auto* entry = tracks[i];
+		if (!entry) {
+			continue;
+		}
+		if (entry->getMixingFrom() || entry->getNext()) {
+			return false;
+		}
+		// A finished animation holds its last frame, one without duration only has one frame
+		if (entry->getAnimation().getDuration() > 0 && (entry->getLoop() || !entry->isComplete())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void SkeletonDrawable::updateHotspots() {
 	hotspots.clear();
 
     if (hotspot_highlight) {
@@ -96,8 +142,7 @@ void SkeletonDrawable::step() {
 
             if (attachment->getRTTI().isExactly(spine::BoundingBoxAttachment::rtti)) {
                 auto* box = reinterpret_cast<spine::BoundingBoxAttachment*>(attachment);
-                const std::string name = std::string(box->getName().buffer());
-                if (name == "non_walkable_area" || name == "walkable_area") {
+                if (kindOf(*box) != BoundingBoxKind::Clickable) {
                     continue;
                 }
 
@@ -130,8 +175,18 @@ void SkeletonDrawable::setAlpha(float alpha) {
 	this->alpha = alpha;
 }
 
+void SkeletonDrawable::flush(const jngl::Mat3& modelview) const {
+	if (batch.vertices.empty()) {
+		return;
+	}
+	RenderQueue::handle().submit(*batch.texture, nullptr, batch.color, batch.blendMode, modelview,
+	                             batch.vertices);
+	++frameStats.batches;
+	batch.vertices.clear();
+}
+
 void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
-	jngl::Sprite* texture = nullptr;
+	ALPACA_PROFILE_ZONE("Spine draw");
 	spine::Array<spine::Slot *> &drawOrder = skeleton->getDrawOrder().getAppliedPose();
 	for (unsigned j = 0; j < drawOrder.size(); ++j) {
 		spine::Slot &slot = *drawOrder[j];
@@ -140,6 +195,7 @@ void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
 			continue;
 		}
 
+		jngl::Sprite* texture = nullptr;
 		spine::Array<float>* vertices = &worldVertices;
 		spine::Array<float>* uvs = nullptr;
 		spine::Array<unsigned short>* indices = nullptr;
@@ -158,7 +214,7 @@ void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
 			indices = &quadIndices;
 			indicesCount = 6;
 			if(region){
-				texture = reinterpret_cast<jngl::Sprite*>(region->getRendererObject());
+				texture = &static_cast<AtlasTexture*>(region->getRendererObject())->sprite();
 			}
 			attachmentColor = &regionAttachment->getColor();
 
@@ -176,7 +232,7 @@ void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
 			}
 
 			if(region){
-				texture = static_cast<jngl::Sprite*>(region->getRendererObject());
+				texture = &static_cast<AtlasTexture*>(region->getRendererObject())->sprite();
 			}
 			vertices->setSize(mesh->getWorldVerticesLength(), 0);
 			mesh->computeWorldVertices(*skeleton, slot, 0, mesh->getWorldVerticesLength(), vertices->buffer(),
@@ -192,6 +248,8 @@ void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
 		} else if (attachment->getRTTI().isExactly(spine::BoundingBoxAttachment::rtti)) {
 #ifndef NDEBUG
             if (debugdraw) {
+                flush(modelview);
+                RenderQueue::handle().flush();
                 auto* box = reinterpret_cast<spine::BoundingBoxAttachment*>(attachment);
 
                 worldVertices.setSize(box->getWorldVerticesLength(), 0);
@@ -200,7 +258,7 @@ void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
                 float* bbvertices = worldVertices.buffer();
                 int vertexCount = box->getWorldVerticesLength();
 
-                if (std::string(box->getName().buffer()) != "non_walkable_area") {
+                if (kindOf(*box) != BoundingBoxKind::NonWalkable) {
                     for (int i = 0; i < vertexCount - 2; i += 2) {
                         jngl::drawLine(modelview, { bbvertices[i], bbvertices[i + 1] }, { bbvertices[i + 2], bbvertices[i + 3] });
                     }
@@ -218,6 +276,8 @@ void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
 		} else if (attachment->getRTTI().isExactly(spine::PointAttachment::rtti)) {
 #ifndef NDEBUG
             if (debugdraw) {
+                flush(modelview);
+                RenderQueue::handle().flush();
                 auto* point = reinterpret_cast<spine::PointAttachment*>(attachment);
 				float x = 0;
 				float y = 0;
@@ -262,27 +322,38 @@ void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
 			indicesCount = clipper.getClippedTriangles().size();
 		}
 
-		std::vector<jngl::Vertex> vertexArray;
+		if (!texture) {
+			clipper.clipEnd(slot);
+			continue;
+		}
+
+		const std::array<uint8_t, 4> color{ r, g, b, static_cast<uint8_t>(a * alpha) };
+		const spine::BlendMode blendMode = slot.getData().getBlendMode();
+		if (texture != batch.texture || color != batch.color || blendMode != batch.blendMode) {
+			flush(modelview);
+			batch.texture = texture;
+			batch.color = color;
+			batch.blendMode = blendMode;
+		}
+
+		const size_t capacity = batch.vertices.capacity();
 		for (size_t i = 0; i < indicesCount; ++i) {
 			int const index = (*indices)[i] << 1;
-			vertexArray.push_back(jngl::Vertex{
+			batch.vertices.push_back(jngl::Vertex{
 			    .x=(*vertices)[index], .y=(*vertices)[index + 1],
 			    .u=(*uvs)[index],     // * size.x
 			    .v=(*uvs)[index + 1], // * size.y
 			});
 		}
-		if (r < 250 || g < 250 || b < 250) {
-			jngl::setSpriteColor(r, g, b);
-		}
-		if (texture) {
-			jngl::setSpriteColor(r, g, b, a * alpha);
-			texture->drawMesh(modelview, vertexArray);
-			jngl::setSpriteColor(255, 255, 255, 255);
+		if (batch.vertices.capacity() != capacity) {
+			++frameStats.allocations;
 		}
+		++frameStats.attachments;
 
 		clipper.clipEnd(slot);
 	}
-	// target.draw(*vertexArray, states);
+	flush(modelview);
+	batch.texture = nullptr;
 	clipper.clipEnd();
 
 	jngl::setSpriteColor(255, 255, 255, 255);
@@ -313,34 +384,6 @@ void SkeletonDrawable::draw(const jngl::Mat3& modelview) const {
 	// }
 }
 
-spine::BoundingBoxAttachment *spSkeletonBounds_containsPointMatchingName(spine::SkeletonBounds *self, const std::string &name, float x, float y) {
-	spine::Array<spine::BoundingBoxAttachment*>& boundingBoxes = self->getBoundingBoxes();
-	spine::Array<spine::Polygon*>& polygons = self->getPolygons();
-	for (size_t i = 0; i < boundingBoxes.size(); ++i)
-	{
-        if (std::string(boundingBoxes[i]->getName().buffer()) == name)
-        {
-            if (self->containsPoint(*polygons[i], x, y))
-            {
-                return boundingBoxes[i];
-            }
-        }
-    }
-    return nullptr;
-}
-
-spine::BoundingBoxAttachment *spSkeletonBounds_containsPointNotMatchingName(spine::SkeletonBounds *self, const std::string &name, float x, float y) {
-	spine::Array<spine::BoundingBoxAttachment*>& boundingBoxes = self->getBoundingBoxes();
-	spine::Array<spine::Polygon*>& polygons = self->getPolygons();
-	for (size_t i = 0; i < boundingBoxes.size(); ++i)
-	{
-        if (std::string(boundingBoxes[i]->getName().buffer()) != name)
-        {
-            if (self->containsPoint(*polygons[i], x, y))
-            {
-                return boundingBoxes[i];
-            }
-        }
-    }
-    return nullptr;
+BoundingBoxKind SkeletonDrawable::kindOf(const spine::BoundingBoxAttachment& box) const {
+	return boundingBoxKinds ? boundingBoxKinds->get(box) : BoundingBoxKinds::classify(box.getName());
 }
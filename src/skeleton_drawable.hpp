@@ -1,9 +1,28 @@
 #pragma once
 
+#include "bounding_box_kind.hpp"
+
 #include <jngl.hpp>
 
+#include <array>
+#include <atomic>
+
 #include <spine/spine.h>
 
+/// Atlas page texture. The image is decoded when the atlas is loaded, which may happen on a worker
+/// thread, while the upload to the GPU is done on the main thread on first use.
+class AtlasTexture {
+public:
+	explicit AtlasTexture(std::unique_ptr<jngl::ImageData>);
+
+	/// Must only be called from the main thread
+	jngl::Sprite& sprite();
+
+private:
+	std::unique_ptr<jngl::ImageData> imageData;
+	std::unique_ptr<jngl::Sprite> uploaded;
+};
+
 class TextureLoader : public spine::TextureLoader {
 public:
 	void load(spine::AtlasPage& page, const spine::String& path) override;
@@ -18,15 +37,48 @@ public:
 	std::unique_ptr<spine::AnimationState> state;
 	float timeScale;
 
+	/// animationStateData is shared between instances of the same Spine project and has to outlive
+	/// this object. If it's nullptr, a private one is created.
 	explicit SkeletonDrawable(spine::SkeletonData& skeleton,
-	                          std::unique_ptr<spine::AnimationStateData> = nullptr);
+	                          spine::AnimationStateData* animationStateData = nullptr);
 	~SkeletonDrawable();
 
-    void step();
+	/// Advances the animation. Returns false without touching the pose if the skeleton is sleeping,
+	/// i.e. its pose has been static for a second: all tracks are empty, finished or hold a single
+	/// frame and nothing is mixing or queued.
+	bool step();
+	/// Has to be called after changing the animation state, skin, scale or anything else that the
+	/// pose depends on
+	void wake();
+	bool isSleeping() const { return sleeping; }
 	void setAlpha(float);
 
 	void draw(const jngl::Mat3& modelview = jngl::modelview()) const;
 
+	/// Counters of all SkeletonDrawables, reset by Game::draw each frame
+	struct FrameStats {
+		int attachments = 0;
+		int batches = 0;
+		int allocations = 0;
+	};
+	static FrameStats frameStats;
+
+	/// Counters of all SkeletonDrawables, reset by Game::step each frame. Atomic since skeletons are
+	/// stepped on the JobPool.
+	struct StepStats {
+		std::atomic<int> awake = 0;
+		std::atomic<int> sleeping = 0;
+		void reset() {
+			awake = 0;
+			sleeping = 0;
+		}
+	};
+	static StepStats stepStats;
+
+	/// Set by SpineObject to the kinds of its SpineData, otherwise bounding boxes are classified by
+	/// name
+	const BoundingBoxKinds* boundingBoxKinds = nullptr;
+
 	bool hotspot_highlight = false;
 	mutable std::vector<jngl::Vec2> hotspots;
 #ifndef NDEBUG
@@ -40,7 +92,26 @@ private:
 	};
 	std::vector<HotspotCache> hotspotCache;
 
-	std::unique_ptr<spine::AnimationStateData> animationStateData;
+	/// Consecutive attachments sharing atlas page, colour and blend mode, drawn with one drawMesh
+	struct Batch {
+		jngl::Sprite* texture = nullptr;
+		std::array<uint8_t, 4> color{};
+		spine::BlendMode blendMode = spine::BlendMode_Normal;
+		std::vector<jngl::Vertex> vertices;
+	};
+	mutable Batch batch;
+	void flush(const jngl::Mat3& modelview) const;
+	BoundingBoxKind kindOf(const spine::BoundingBoxAttachment&) const;
+	void updateHotspots();
+
+	/// Whether another state->update() could change the pose
+	bool poseIsStatic() const;
+	bool sleeping = false;
+	/// Steps in a row in which poseIsStatic() was true. Physics constraints might still be swinging,
+	/// so we don't go to sleep right away.
+	int staticSteps = 0;
+
+	std::unique_ptr<spine::AnimationStateData> ownAnimationStateData;
 	mutable spine::Array<float> worldVertices;
 	mutable spine::Array<unsigned short> quadIndices;
 	mutable spine::SkeletonClipping clipper;
@@ -48,6 +119,3 @@ private:
 
 };
 
-
-spine::BoundingBoxAttachment *spSkeletonBounds_containsPointMatchingName(spine::SkeletonBounds *self, const std::string &name, float x, float y);
-spine::BoundingBoxAttachment *spSkeletonBounds_containsPointNotMatchingName(spine::SkeletonBounds *self, const std::string &name, float x, float y);
@@ -0,0 +1,117 @@
+#include "spine_data_cache.hpp"
+
+#include "skeleton_drawable.hpp"
+
+void SpineData::uploadTextures() {
+	if (texturesUploaded) {
+		return;
+	}
+	auto& pages = atlas->getPages();
+	for (size_t i = 0; i < pages.size(); ++i) {
+		static_cast<AtlasTexture*>(pages[i]->texture)->sprite();
+	}
+	texturesUploaded = true;
+}
+
+std::shared_ptr<SpineData> SpineDataCache::get(const std::string& spineFile, float scale) {
+	auto key = std::make_pair(spineFile, scale);
+	std::unique_lock lock(mutex);
+	if (auto it = cache.find(key); it != cache.end()) {
+		const auto entry = it->second;
+		lock.unlock();
+		return entry.get(); // blocks only if another thread is still loading this project
+	}
+	std::promise<std::shared_ptr<SpineData>> promise;
+	cache.emplace(key, promise.get_future().share());
+	lock.unlock();
+
+	std::shared_ptr<SpineData> data;
+	try {
+		data = load(spineFile, scale);
+	} catch (...) {
+		promise.set_value(nullptr); // threads waiting for this entry get nullptr, too
+		forgetFailed(key);
+		throw;
+	}
+	promise.set_value(data);
+	if (!data) {
+		forgetFailed(key);
+	}
+	return data;
+}
+
+void SpineDataCache::forgetFailed(const std::pair<std::string, float>& key) {
+	// Don't remember errors, so that the next call tries again (e.g. after hot reloading)
+	const std::lock_guard lock(mutex);
+	if (auto it = cache.find(key); it != cache.end() && isReady(it->second) && !it->second.get()) {
+		cache.erase(it);
+	}
+}
+
+void SpineDataCache::releaseUnused() {
+	const std::lock_guard lock(mutex);
+	// The shared state of a ready entry holds the only reference if no object uses the data
+	std::erase_if(cache, [](const auto& entry) {
+		return isReady(entry.second) && entry.second.get().use_count() == 1;
+	});
+	std::erase_if(atlases, [](const auto& entry) { return entry.second.expired(); });
+}
+
+void SpineDataCache::clear() {
+	const std::lock_guard lock(mutex);
+	cache.clear();
+	atlases.clear();
+}
+
+std::shared_ptr<spine::Atlas> SpineDataCache::getAtlas(const std::string& spineFile) {
+	{
+		const std::lock_guard lock(mutex);
+		if (auto atlas = atlases[spineFile].lock()) {
+			return atlas;
+		}
+	}
+	auto atlas = std::make_shared<spine::Atlas>((spineFile + "/" + spineFile + ".atlas").c_str(),
+	                                            &SkeletonDrawable::textureLoader);
+	const std::lock_guard lock(mutex);
+	auto& cached = atlases[spineFile];
+	if (auto other = cached.lock()) {
+		return other; // another thread has loaded it in the meantime
+	}
+	cached = atlas;
+	return atlas;
+}
+
+bool SpineDataCache::isReady(const std::shared_future<std::shared_ptr<SpineData>>& entry) {
+	return entry.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+std::shared_ptr<SpineData> SpineDataCache::load(const std::string& spineFile, float scale) {
+	auto data = std::make_shared<SpineData>();
+	data->spineFile = spineFile;
+	data->scale = scale;
+	data->atlas = getAtlas(spineFile);
+	const std::string skel = jngl::readAsset(spineFile + "/" + spineFile + ".skel").str();
+	if (!skel.empty()) {
+		spine::SkeletonBinary binary(*data->atlas);
+		binary.setScale(scale);
+		data->skeletonData.reset(binary.readSkeletonData(
+		    reinterpret_cast<const unsigned char*>(skel.data()), static_cast<int>(skel.size())));
+		if (!data->skeletonData) {
+			jngl::error("Fatal Error loading {}.skel: {}", spineFile, binary.getError().buffer());
+			return nullptr;
+		}
+	} else {
+		// No binary export, fall back to the JSON file
+		spine::SkeletonJson json(*data->atlas);
+		json.setScale(scale);
+		data->skeletonData.reset(
+		    json.readSkeletonDataFile((spineFile + "/" + spineFile + ".json").c_str()));
+		if (!data->skeletonData) {
+			jngl::error("Fatal Error loading {}: {}", spineFile, json.getError().buffer());
+			return nullptr;
+		}
+	}
+	data->animationStateData = std::make_unique<spine::AnimationStateData>(*data->skeletonData);
+	data->boundingBoxKinds.add(*data->skeletonData);
+	return data;
+}
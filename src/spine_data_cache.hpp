@@ -0,0 +1,59 @@
+#pragma once
+
+#include "bounding_box_kind.hpp"
+
+#include <jngl.hpp>
+#include <spine/spine.h>
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+/// Atlas, Skeleton- und Mix-Daten eines Spine Projekts, die sich alle Instanzen teilen
+struct SpineData {
+public:
+	std::string spineFile;
+	float scale = 1;
+	// Order matters: skeletonData references the atlas regions, animationStateData the skeletonData
+	/// Independent of scale, shared with the SpineData of the same file at other scales
+	std::shared_ptr<spine::Atlas> atlas;
+	std::unique_ptr<spine::SkeletonData> skeletonData;
+	std::unique_ptr<spine::AnimationStateData> animationStateData;
+	BoundingBoxKinds boundingBoxKinds;
+
+	/// Uploads the atlas pages to the GPU, has to be called from the main thread
+	void uploadTextures();
+
+private:
+	bool texturesUploaded = false;
+};
+
+/// Parses each Spine project only once per (file, scale) and hands out shared, read-only data. The
+/// atlas and its textures are only loaded once per file.
+class SpineDataCache : public jngl::Singleton<SpineDataCache> {
+public:
+	/// Loads data/<spineFile>/<spineFile>.atlas and .skel (or .json if there is no binary export) on
+	/// first use, returns nullptr on errors. Only waits for other threads if they are loading the
+	/// same project.
+	std::shared_ptr<SpineData> get(const std::string& spineFile, float scale = 1);
+
+	/// Drops entries which are no longer used by any object, call after a scene has been loaded
+	void releaseUnused();
+
+	/// Forgets everything, objects still holding data keep it alive. Used by hot reloading.
+	void clear();
+
+private:
+	std::shared_ptr<SpineData> load(const std::string& spineFile, float scale);
+	/// Loads data/<spineFile>/<spineFile>.atlas unless a SpineData of another scale still uses it
+	std::shared_ptr<spine::Atlas> getAtlas(const std::string& spineFile);
+	void forgetFailed(const std::pair<std::string, float>& key);
+	static bool isReady(const std::shared_future<std::shared_ptr<SpineData>>&);
+
+	/// Only guards cache, not the loading itself
+	std::mutex mutex;
+	/// Not ready yet while a thread is loading the entry
+	std::map<std::pair<std::string, float>, std::shared_future<std::shared_ptr<SpineData>>> cache;
+	std::map<std::string, std::weak_ptr<spine::Atlas>> atlases;
+};
@@ -2,6 +2,8 @@
 #include "game.hpp"
 #include "jngl/log.hpp"
 #include "shader_cache.hpp"
+#include "profiler.hpp"
+#include <algorithm>
 
 // void SpineObject::animationStateListener(spAnimationState *state, spEventType type, spTrackEntry
 // *entry,
@@ -62,35 +64,22 @@ SpineObject::SpineObject(const std::shared_ptr<Game>& game, const std::string& s
                          std::string id, float scale)
 : scale(scale), spine_name(spine_file),
   id(std::move(id)), game(game) {
-	atlas = std::make_unique<spine::Atlas>((spine_file + "/" + spine_file + ".atlas").c_str(),
-	                                       &SkeletonDrawable::textureLoader);
-	assert(atlas);
-	auto json = std::make_unique<spine::SkeletonJson>(*atlas);
-	json->setScale(scale);
-
-#ifndef NDEBUG
-	while (true) {
-#endif
-		skeletonData.reset(
-		    json->readSkeletonDataFile((spine_file + "/" + spine_file + ".json").c_str()));
-		if (!skeletonData) {
-			jngl::error("Fatal Error loading {}: {}", spine_file, json->getError().buffer());
+	spineData = SpineDataCache::handle().get(spine_file, scale);
 #ifndef NDEBUG
-			atlas =
-			    std::make_unique<spine::Atlas>((spine_file + "/" + spine_file + ".atlas").c_str(),
-			                                   &SkeletonDrawable::textureLoader);
-			json = std::make_unique<spine::SkeletonJson>(*atlas);
-            json->setScale(scale);
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
-        }
-		break;
-#endif
+	while (!spineData) {
+		// The Spine project might currently be exported by prepare_assets, retry
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		spineData = SpineDataCache::handle().get(spine_file, scale);
 	}
+#endif
+	assert(spineData);
+	spineData->uploadTextures();
 
-	auto animationStateData = std::make_unique<spine::AnimationStateData>(*skeletonData);
-	skeleton = std::make_unique<SkeletonDrawable>(*skeletonData, std::move(animationStateData));
+	skeleton = std::make_unique<SkeletonDrawable>(*spineData->skeletonData,
+	                                              spineData->animationStateData.get());
+	skeleton->boundingBoxKinds = &spineData->boundingBoxKinds;
 	bounds = std::make_unique<spine::SkeletonBounds>();
+	game->getScriptCache().prepareEvents(*game->lua_state, spineData);
 
 	skeleton->step();
 }
@@ -142,13 +131,14 @@ void SpineObject::playAnimation(int trackIndex, const std::string& currentAnimat
 
     if (auto _game = game.lock()) {
         if (callback) {
-            this->animation_callback.emplace(std::to_string(trackIndex) + currentAnimation,
+            this->animation_callback.emplace(std::pair(trackIndex, currentAnimation),
                                              LuaCallback(std::move(*callback), _game->lua_state));
         }
     }
     if (trackIndex == 0) {
         this->currentAnimation = currentAnimation;
     }
+    skeleton->wake();
     spine::Animation* animation =
         skeleton->state->getData().getSkeletonData().findAnimation(currentAnimation.c_str());
     if (animation) {
@@ -156,56 +146,11 @@ void SpineObject::playAnimation(int trackIndex, const std::string& currentAnimat
                                       static_cast<int>(loop))
             .setListener([this](spine::AnimationState*, spine::EventType type,
                                 spine::TrackEntry* entry, spine::Event* event) {
-            if (event) {
-                if (event->getData().getAudioPath() != nullptr) {
-                    jngl::debug(std::string(event->getData().getAudioPath().buffer()));
-                    try {
-                        jngl::play("audio/" + std::string(event->getData().getAudioPath().buffer()));
-                    } catch (const std::runtime_error& err) {
-                        jngl::error("Failed to play audio: {}", err.what());
-                    }
-                }
-                auto event_data = event->getData().getSetupPose();
-                // getString() is non-const, so don't make event_str const
-                auto event_str = event_data.getString().buffer();
-                if (event_str != nullptr) {
-                    // This in Lua setzen
-
-                    jngl::debug(event_str);
-
-                    if (auto _game = this->game.lock()) {
-
-                        (*_game->lua_state)["this"] = this->getptr();
-                        std::string extension = ".lua";
-                        std::string event_string = std::string(event_str);
-                        if (std::equal(extension.rbegin(), extension.rend(),
-                                       event_string.rbegin())) {
-                            // run lua script from file
-                            _game->runAction(event_string.erase(event_string.size() - 4),
-                                             (*_game->lua_state)["this"]);
-                        } else {
-							auto result = _game->lua_state->safe_script(event_string, sol::script_pass_on_error);
-							if (!result.valid())
-							{
-								const sol::error err = result;
-								jngl::debug("Failed run script via Event {} {}", event->getData().getName().buffer(), err.what());
-							}
-                        }
-                    }
-                }
-            }
-
-            switch (type) {
-            case spine::EventType_Interrupt:
-                break;
-
-            case spine::EventType_Complete:
-                if (!entry->getLoop()) {
-                    onAnimationComplete(entry->getTrackIndex(), std::string(entry->getAnimation().getName().buffer()));
-                }
-                break;
-            default:
-                break;
+            // Might be called on a worker thread by animate(), dispatchEvents() handles them later
+            if (event || (type == spine::EventType_Complete && !entry->getLoop())) {
+                queuedEvents.push_back(QueuedEvent{ type, entry->getTrackIndex(),
+                                                    &entry->getAnimation(),
+                                                    event ? &event->getData() : nullptr });
             }
         });
     } else {
@@ -222,15 +167,54 @@ void SpineObject::playAnimation(int trackIndex, const std::string& currentAnimat
 void SpineObject::stopAnimation(int trackIndex) {
 	if (auto _game = game.lock()) {
 		skeleton->state->setEmptyAnimation(trackIndex, 0.1f);
-		animation_callback.erase(std::to_string(trackIndex) + "<empty>");
+		skeleton->wake();
+		const auto it = animation_callback.find(std::pair<int, std::string_view>(trackIndex, "<empty>"));
+		if (it != animation_callback.end()) {
+			animation_callback.erase(it);
+		}
 	}
 }
 
+void SpineObject::dispatchEvents() {
+    // Callbacks might queue new events, e.g. by playing another animation. Swapping keeps the
+    // capacity of both vectors, so that dispatching doesn't allocate once they're large enough.
+    dispatchingEvents.swap(queuedEvents);
+    for (const auto& queued : dispatchingEvents) {
+        auto _game = this->game.lock();
+        if (queued.data && _game) {
+            // Sounds and scripts have been loaded and compiled when the object was created
+            const auto& action = _game->getScriptCache().getEvent(*_game->lua_state, spineData,
+                                                                      *queued.data);
+            if (action.sound) {
+                action.sound->play();
+            }
+            if (!action.script.empty()) {
+                _game->runAction(action.script, getptr());
+            } else if (action.code.valid()) {
+                // A copy, since the script might clear the cache
+                const sol::protected_function code = action.code;
+                (*_game->lua_state)["this"] = getptr();
+                auto result = code();
+                if (!result.valid())
+                {
+                    const sol::error err = result;
+                    jngl::debug("Failed run script via Event {} {}", queued.data->getName().buffer(), err.what());
+                }
+            }
+        }
+
+        if (queued.type == spine::EventType_Complete) {
+            onAnimationComplete(queued.trackIndex, queued.animation->getName().buffer());
+        }
+    }
+    dispatchingEvents.clear();
+}
+
 void SpineObject::addAnimation(int trackIndex, const std::string& currentAnimation, bool loop,
                                float delay, std::optional<sol::function> callback) {
 	if (auto _game = game.lock()) {
 		if (callback) {
-			this->animation_callback.emplace(std::to_string(trackIndex) + currentAnimation,
+			this->animation_callback.emplace(std::pair(trackIndex, currentAnimation),
 			                                 LuaCallback(std::move(*callback), _game->lua_state));
 		}
 		if (trackIndex == 0) {
@@ -240,23 +224,20 @@ void SpineObject::addAnimation(int trackIndex, const std::string& currentAnimati
 		    skeleton->state->getData().getSkeletonData().findAnimation(currentAnimation.c_str());
 		if (animation) {
 			skeleton->state->addAnimation(trackIndex, *animation, static_cast<int>(loop), delay);
+			skeleton->wake();
         } else {
             jngl::error("The animation {} is missing for {}.spine", currentAnimation, spine_name);
         }
     }
 }
 
-void SpineObject::onAnimationComplete(const int index, const std::string& animation) {
+void SpineObject::onAnimationComplete(const int index, const std::string_view animation) {
 	if (auto _game = game.lock()) {
 		if (!deleted && index == 0) {
 			// Set animation back to default animation in Lua state
-			auto lua_object = _game->getObjectTable(getId());
-			std::string animation = (*_game->lua_state)["config"]["spine_default_animation"];
-			lua_object["animation"] = animation;
-			lua_object["loop_animation"] = true;
+			setLuaAnimation(_game->getEngineConfig().spineDefaultAnimation, true);
 		}
-		const auto key = std::to_string(index) + animation;
-		auto it = animation_callback.find(key);
+		auto it = animation_callback.find(std::pair(index, animation));
 		if (it != animation_callback.end()) {
 			it->second();
 			animation_callback.erase(it);
@@ -266,6 +247,7 @@ void SpineObject::onAnimationComplete(const int index, const std::string& animat
 
 void SpineObject::setSkin(const std::string& skin) {
 	this->skins = { skin };
+	skeleton->wake();
 	if (skin.empty()) {
 		skeleton->skeleton->setSkin((spine::Skin*)nullptr);
 
@@ -280,6 +262,7 @@ void SpineObject::setSkin(const std::string& skin) {
 
 void SpineObject::setSkins(const std::vector<std::string>& skins) {
 	this->skins = skins;
+	skeleton->wake();
 	if (skins.size() == 1 && skins[0].empty()) {
 		skeleton->skeleton->setSkin(nullptr);
 		combinedSkin.reset();
@@ -288,7 +271,7 @@ void SpineObject::setSkins(const std::vector<std::string>& skins) {
 
     auto newSkin = std::make_unique<spine::Skin>("new-skin"); // 1. Create a new empty skin
     for (auto const& skin : skins) {
-		auto* skinPtr = skeletonData->findSkin(skin.c_str());
+		auto* skinPtr = spineData->skeletonData->findSkin(skin.c_str());
 		if (!skinPtr) {
 			jngl::error("The Skin " + skin + " is missing for " + spine_name + ".spine");
 			continue;
@@ -300,6 +283,196 @@ void SpineObject::setSkins(const std::vector<std::string>& skins) {
 	skeleton->skeleton->setupPoseSlots();
 }
 
+void SpineObject::animate() {
+	posed = skeleton->step();
+	if (posed) {
+		boundsDirty = true;
+		if (hasNavigationBounds()) {
+			ensureBounds();
+		}
+	}
+}
+
+bool SpineObject::stepSkeleton() {
+	const bool changed = skeleton->step();
+	if (!queuedEvents.empty()) {
+		dispatchEvents();
+	}
+	return changed;
+}
+
+void SpineObject::afterAnimate() {
+	if (posed) {
+		publishBounds();
+	}
+	if (!queuedEvents.empty()) {
+		dispatchEvents();
+	}
+}
+
+bool SpineObject::hasNavigationBounds() const {
+	return spineData->boundingBoxKinds.has(BoundingBoxKind::Walkable) ||
+	       spineData->boundingBoxKinds.has(BoundingBoxKind::NonWalkable);
+}
+
+void SpineObject::markBoundsDirty() {
+	boundsDirty = true;
+	publishBounds();
+}
+
+void SpineObject::publishBounds() {
+	if (!bounds || boundsQueued) {
+		return;
+	}
+	auto _game = game.lock();
+	if (!_game || !handle || hasNavigationBounds()) {
+		updateBounds();
+		return;
+	}
+	boundsQueued = true;
+	_game->boundsChanged(weak_from_this());
+}
+
+void SpineObject::ensureBounds() const {
+	if (boundsDirty) {
+		bounds->update(*skeleton->skeleton, true);
+		updateBoundingBoxKinds();
+		boundsDirty = false;
+	}
+}
+
+void SpineObject::updateBounds() {
+	ALPACA_PROFILE_ZONE("Bounds");
+	boundsQueued = false;
+	ensureBounds();
+	updateObstacles();
+	updateHitBox();
+}
+
+void SpineObject::updateBoundingBoxKinds() const {
+	const auto& boundingBoxes = bounds->getBoundingBoxes();
+	if (classifiedBoundingBoxes.size() == boundingBoxes.size() &&
+	    std::equal(classifiedBoundingBoxes.begin(), classifiedBoundingBoxes.end(),
+	               boundingBoxes.buffer())) {
+		return; // Same attachments as in the last frame
+	}
+	classifiedBoundingBoxes.assign(boundingBoxes.buffer(),
+	                               boundingBoxes.buffer() + boundingBoxes.size());
+	boundingBoxKinds.clear();
+	for (const auto* box : classifiedBoundingBoxes) {
+		boundingBoxKinds.push_back(spineData->boundingBoxKinds.get(*box));
+	}
+}
+
+spine::BoundingBoxAttachment* SpineObject::containsPoint(const BoundingBoxKind kind,
+                                                         const jngl::Vec2 point) const {
+	if (!spineData->boundingBoxKinds.has(kind)) {
+		return nullptr;
+	}
+	ensureBounds();
+	const auto x = static_cast<float>(point.x);
+	const auto y = static_cast<float>(point.y);
+	if (!bounds->aabbContainsPoint(x, y)) {
+		return nullptr;
+	}
+	auto& boundingBoxes = bounds->getBoundingBoxes();
+	auto& polygons = bounds->getPolygons();
+	for (size_t i = 0; i < boundingBoxes.size(); ++i) {
+		if (boundingBoxKinds[i] == kind && bounds->containsPoint(*polygons[i], x, y)) {
+			return boundingBoxes[i];
+		}
+	}
+	return nullptr;
+}
+
+void SpineObject::updateHitBox() {
+	auto _game = game.lock();
+	if (!_game) {
+		return;
+	}
+	std::optional<HitIndex::Box> box;
+	if (handle) {
+		for (const auto* polygon : bounds->getPolygons()) {
+			for (int i = 0; i + 1 < polygon->_count; i += 2) {
+				const float x = polygon->_vertices[i] + static_cast<float>(position.x);
+				const float y = polygon->_vertices[i + 1] + static_cast<float>(position.y);
+				if (!box) {
+					box = HitIndex::Box{ x, y, x, y };
+				}
+				box->minX = std::min(box->minX, x);
+				box->minY = std::min(box->minY, y);
+				box->maxX = std::max(box->maxX, x);
+				box->maxY = std::max(box->maxY, y);
+			}
+		}
+	}
+	if (box == hitBox && handle == hitBoxHandle && abs_position == hitBoxScreenSpace) {
+		return;
+	}
+	if (box) {
+		_game->hitIndex.update(handle, *box, abs_position);
+	} else {
+		_game->hitIndex.erase(hitBoxHandle);
+	}
+	hitBox = box;
+	hitBoxHandle = handle;
+	hitBoxScreenSpace = abs_position;
+}
+
+spine::BoundingBoxAttachment* SpineObject::hitTest(const jngl::Vec2 point) const {
+	return containsPoint(BoundingBoxKind::Clickable, point);
+}
+
+void SpineObject::updateObstacles() {
+	const auto& boundingBoxes = bounds->getBoundingBoxes();
+	const auto& polygons = bounds->getPolygons();
+	bool changed = false;
+	size_t offset = 0;
+	for (size_t i = 0; i < boundingBoxes.size() && !changed; i++) {
+		if (boundingBoxKinds[i] != BoundingBoxKind::NonWalkable) {
+			continue;
+		}
+		const auto& polygon = *polygons[i];
+		const auto count = static_cast<size_t>(polygon._count);
+		changed = offset + 1 + count > obstacleVertices.size() ||
+		          obstacleVertices[offset] != static_cast<float>(count) ||
+		          !std::equal(polygon._vertices.buffer(), polygon._vertices.buffer() + count,
+		                      obstacleVertices.begin() + static_cast<ptrdiff_t>(offset) + 1);
+		offset += 1 + count;
+	}
+	if (!changed && offset == obstacleVertices.size() &&
+	    (offset == 0 || (visible == obstacleVisible && position.x == obstaclePosition.x &&
+	                     position.y == obstaclePosition.y))) {
+		return; // The usual case, nothing moved or the object has no obstacles at all
+	}
+
+	obstacleVertices.clear();
+	obstacles.clear();
+	for (size_t i = 0; i < boundingBoxes.size(); i++) {
+		if (boundingBoxKinds[i] != BoundingBoxKind::NonWalkable) {
+			continue;
+		}
+		const auto& polygon = *polygons[i];
+		obstacleVertices.push_back(static_cast<float>(polygon._count));
+		obstacleVertices.insert(obstacleVertices.end(), polygon._vertices.buffer(),
+		                        polygon._vertices.buffer() + polygon._count);
+		if (!visible || polygon._count < 2) {
+			continue;
+		}
+		auto& obstacle = obstacles.emplace_back();
+		for (int j = 0; j < polygon._count; j += 2) {
+			obstacle.emplace_back(jngl::Vec2(polygon._vertices[j], polygon._vertices[j + 1]) + position);
+		}
+		// Add first to the back again.
+		obstacle.push_back(obstacle.front());
+	}
+	obstacleVisible = visible;
+	obstaclePosition = position;
+	if (auto _game = game.lock()) {
+		_game->obstaclesChanged();
+	}
+}
+
 double SpineObject::getZ() const {
 	return position.y + (layer * 2000.0);
 }
@@ -312,11 +485,48 @@ void SpineObject::toLuaState() {
 		}
 
 		(*_game->lua_state)["scenes"][scene]["items"][id] = _game->lua_state->create_table_with(
-		    "spine", spine_name, "object", shared_from_this(), "x", position.x, "y", position.y,
+		    "spine", spine_name, "x", position.x, "y", position.y,
 		    "animation", currentAnimation, "loop_animation", true, "visible", visible,
 		    "cross_scene", cross_scene, "abs_position", abs_position, "shader", shader, "layer", layer, "skin",
 		    sol::as_table(skins), "scale", scale);
 	}
+	luaDirty = 0; // the whole table has just been written
+}
+
+void SpineObject::syncLuaState() {
+	if (!luaDirty || deleted) {
+		return;
+	}
+	if (auto _game = game.lock()) {
+		sol::table lua_object = _game->getObjectTable(getId());
+		if (lua_object.valid()) {
+			writeLuaFields(lua_object, luaDirty);
+		}
+	}
+	luaDirty = 0;
+}
+
+void SpineObject::writeLuaFields(sol::table& luaObject, const uint8_t fields) {
+	if (fields & LuaPosition) {
+		luaObject["x"] = luaPosition.x;
+		luaObject["y"] = luaPosition.y;
+	}
+	if (fields & LuaAnimation) {
+		luaObject["animation"] = luaAnimation;
+		luaObject["loop_animation"] = luaLoopAnimation;
+	}
+	if (fields & LuaVisible) {
+		luaObject["visible"] = visible;
+	}
+	if (fields & LuaLayer) {
+		luaObject["layer"] = layer;
+	}
+	if (fields & LuaSkin) {
+		luaObject["skin"] = sol::as_table(skins);
+	}
+	if (fields & LuaScale) {
+		luaObject["scale"] = scale;
+	}
 }
 
 void SpineObject::setCrossScene(bool cross_scene) {
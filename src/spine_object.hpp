@@ -2,11 +2,15 @@
 
 #include <memory>
 #include <map>
+#include <string_view>
 #include <jngl/Vec2.hpp>
 #include <spine/spine.h>
 #include "skeleton_drawable.hpp"
+#include "spine_data_cache.hpp"
 #include <sol/sol.hpp>
 #include "lua_callback.hpp"
+#include "object_store.hpp"
+#include "hit_index.hpp"
 
 struct spSkeletonData;
 class Game;
@@ -25,13 +29,26 @@ public:
 		return shared_from_this();
 	}
 
+	/// Animation phase of Game::step, runs on a JobPool thread: advances the skeleton and updates
+	/// the bounds of objects which are part of the navigation. Must not touch anything but this
+	/// object, Spine events are queued.
+	void animate();
+	/// Called on the main thread after animate(): publishes the new bounds and dispatches the
+	/// queued Spine events to Lua
+	void afterAnimate();
+
 	/// true zurückgeben damit das Objekt entfernt wird
 	virtual bool step(bool force = false) = 0;
 
 	virtual void draw() const = 0;
 
 	jngl::Vec2 getPosition() { return position; }
-	void setPosition(jngl::Vec2 position) { this->position = position; }
+	void setPosition(jngl::Vec2 position)
+	{
+		this->position = position;
+		depthDirty = true;
+		markBoundsDirty();
+	}
 
 	std::shared_ptr<SpineObject> getParent() { return parent; }
 	void setParent(std::shared_ptr<SpineObject> parent) { this->parent = parent; }
@@ -45,20 +62,51 @@ public:
 		this->scale = scale;
 		skeleton->skeleton->setScaleX(scale);
 		skeleton->skeleton->setScaleY(scale);
+		skeleton->wake();
 	}
 
-	void setVisible(bool visible) { this->visible = visible; }
+	void setVisible(bool visible)
+	{
+		if (this->visible != visible)
+		{
+			this->visible = visible;
+			// Hidden objects are no obstacles and can't be hit, even if their skeleton sleeps
+			markBoundsDirty();
+		}
+	}
 	bool getVisible() { return visible; }
 
+	/// non_walkable_area polygons in world coordinates, closed like VisibilityGraph expects them.
+	/// Empty while the object is invisible. Only recomputed by updateBounds() when the polygons,
+	/// the position or the visibility changed.
+	const std::vector<std::vector<jngl::Vec2>>& getObstacles() const { return obstacles; }
+
+	/// ensureBounds(), moves the object in Game::hitIndex and tells the Game if getObstacles()
+	/// changed
+	void updateBounds();
+
+	/// Kind of bounds->getBoundingBoxes()[index], call ensureBounds() first
+	BoundingBoxKind getBoundingBoxKind(size_t index) const { return boundingBoxKinds[index]; }
+
+	/// First bounding box of the kind that contains point (relative to getPosition()) or nullptr.
+	/// Only tests the polygons if the skeleton has boxes of this kind at all and the point is
+	/// inside their AABB.
+	spine::BoundingBoxAttachment* containsPoint(BoundingBoxKind, jngl::Vec2 point) const;
+
+	/// Returns the bounding box which can be clicked at point (relative to getPosition()) or nullptr.
+	/// Used by Game::getPointerHit() for the candidates HitIndex found, walkable_area and
+	/// non_walkable_area can't be clicked by default.
+	virtual spine::BoundingBoxAttachment* hitTest(jngl::Vec2 point) const;
+
+	/// Shared with all other objects of the same Spine project, has to be declared before skeleton
+	std::shared_ptr<SpineData> spineData;
 	std::unique_ptr<SkeletonDrawable> skeleton;
 	std::unique_ptr<spine::SkeletonBounds> bounds;
-	std::unique_ptr<spine::SkeletonData> skeletonData;
-	std::unique_ptr<spine::Atlas> atlas;
 	std::optional<jngl::Vec2> getPoint(const std::string &point_name) const;
 	void playAnimation(int trackIndex, const std::string &currentAnimation, bool loop, std::optional<sol::function> callback = std::nullopt);
 	void stopAnimation(int trackIndex);
 	void addAnimation(int trackIndex, const std::string &currentAnimation, bool loop, float delay, std::optional<sol::function> callback = std::nullopt);
-	void onAnimationComplete(int index, const std::string &animation);
+	void onAnimationComplete(int index, std::string_view animation);
 	void setSkin(const std::string &skin);
 	void setSkins(const std::vector<std::string> &skins);
 	std::vector<std::string> getPointNames() const;
@@ -68,9 +116,48 @@ public:
 	std::string getName() { return spine_name; };
 	std::string getId() { return id; };
 	virtual double getZ() const;
-	int layer = 1;
+	int getLayer() const { return layer; }
+	void setLayer(int layer)
+	{
+		this->layer = layer;
+		depthDirty = true;
+	}
 	void setDeleted() { deleted = true; };
+	/// Invalid until the object has been added to Game::gameObjects
+	ObjectHandle getHandle() const { return handle; }
 	void toLuaState();
+
+	/// Fields of the object's table in the Lua state (see Game::getObjectTable()) that changed
+	/// since the last syncLuaState()
+	enum LuaField : uint8_t {
+		LuaPosition = 1 << 0,
+		LuaAnimation = 1 << 1,
+		LuaVisible = 1 << 2,
+		LuaLayer = 1 << 3,
+		LuaSkin = 1 << 4,
+		LuaScale = 1 << 5,
+		/// Only used by Player
+		LuaMaxSpeed = 1 << 6,
+	};
+	void markLuaDirty(uint8_t fields) { luaDirty |= fields; }
+	/// x and y in the Lua table, which isn't always getPosition(), e.g. Player stores where it's
+	/// walking to
+	void setLuaPosition(jngl::Vec2 position)
+	{
+		luaPosition = position;
+		luaDirty |= LuaPosition;
+	}
+	/// animation and loop_animation in the Lua table, i.e. what's played when the scene is loaded again
+	void setLuaAnimation(const std::string& animation, bool loop)
+	{
+		luaAnimation = animation;
+		luaLoopAnimation = loop;
+		luaDirty |= LuaAnimation;
+	}
+	/// Writes the dirty fields into the Lua table, called by Game at the end of each step, before
+	/// saving and when the object is removed
+	void syncLuaState();
+
     bool getCrossScene() const {return cross_scene;};
     void setCrossScene(bool cross_scene);
 
@@ -84,8 +171,39 @@ public:
     void setShader(std::string_view shader);
 
 protected:
+	/// Tells Game::gameObjects that getZ() might have changed
+	void markDepthDirty() { depthDirty = true; }
+
+	/// Call after the pose or the position changed. Objects with walkable_area or non_walkable_area
+	/// boxes update their bounds right away, because the navigation has to know about every change.
+	/// All others only do so when a hit test needs them, see Game::getPointerHit().
+	void markBoundsDirty();
+	/// Whether bounds are needed every frame for the navigation
+	bool hasNavigationBounds() const;
+
+	/// Updates bounds to the current pose if it has been marked dirty
+	void ensureBounds() const;
+
+	/// For objects Game::animateObjects() doesn't animate, e.g. the pointer: advances the skeleton
+	/// and dispatches its Spine events right away. Returns whether the pose changed.
+	bool stepSkeleton();
+
+	/// Writes fields (a combination of LuaField) into the object's Lua table
+	virtual void writeLuaFields(sol::table& luaObject, uint8_t fields);
+
+	int layer = 1;
 	std::string currentAnimation = "idle";
-	std::map<std::string, LuaCallback> animation_callback;
+	/// Orders (track index, animation name) keys, also against std::pair<int, std::string_view>, so
+	/// that onAnimationComplete() can look them up without building a string
+	struct AnimationCallbackLess {
+		using is_transparent = void;
+		template <class Lhs, class Rhs>
+		bool operator()(const Lhs& lhs, const Rhs& rhs) const {
+			return std::pair<int, std::string_view>(lhs.first, lhs.second) <
+			       std::pair<int, std::string_view>(rhs.first, rhs.second);
+		}
+	};
+	std::map<std::pair<int, std::string>, LuaCallback, AnimationCallbackLess> animation_callback;
 	std::optional<LuaCallback> walk_callback;
 
 	bool cross_scene = false;
@@ -102,4 +220,56 @@ protected:
 	std::shared_ptr<SpineObject> parent = nullptr;
     jngl::ShaderProgram* shaderProgram = nullptr;
     std::optional<int> shaderTwoPassUniform;
+
+private:
+	friend class DepthOrder;
+	friend class ObjectStore;
+	bool depthDirty = true;
+	ObjectHandle handle;
+	/// Erased from Game::gameObjects, but still part of its DepthOrder until the next update()
+	bool removed = false;
+	bool ordered = false;
+
+	uint8_t luaDirty = 0;
+	jngl::Vec2 luaPosition;
+	std::string luaAnimation;
+	bool luaLoopAnimation = true;
+
+	mutable bool boundsDirty = true;
+	/// Waiting for Game::getPointerHit() to call updateBounds()
+	bool boundsQueued = false;
+	/// Updates Game::hitIndex and the obstacles now or queues this object for getPointerHit()
+	void publishBounds();
+	/// The last animate() changed the pose
+	bool posed = false;
+
+	/// Spine event or the completion of a non-looping animation
+	struct QueuedEvent {
+		spine::EventType type;
+		int trackIndex;
+		spine::Animation* animation;
+		/// nullptr for EventType_Complete
+		const spine::EventData* data;
+	};
+	std::vector<QueuedEvent> queuedEvents;
+	std::vector<QueuedEvent> dispatchingEvents;
+	void dispatchEvents();
+
+	/// Looks up the kinds of the bounding boxes in spineData if the attachments changed
+	void updateBoundingBoxKinds() const;
+	mutable std::vector<const spine::BoundingBoxAttachment*> classifiedBoundingBoxes;
+	mutable std::vector<BoundingBoxKind> boundingBoxKinds;
+
+	void updateObstacles();
+	std::vector<std::vector<jngl::Vec2>> obstacles;
+	/// Point count and local vertices of each non_walkable_area that obstacles have been computed from
+	std::vector<float> obstacleVertices;
+	jngl::Vec2 obstaclePosition;
+	bool obstacleVisible = false;
+
+	void updateHitBox();
+	/// What Game::hitIndex currently knows about this object
+	std::optional<HitIndex::Box> hitBox;
+	ObjectHandle hitBoxHandle;
+	bool hitBoxScreenSpace = false;
 };
@@ -0,0 +1,199 @@
+#include "visibility_graph.hpp"
+
+namespace {
+
+enum class Result {
+	INTERSECTION,
+	NO_INTERSECTION,
+	TWO_POINTS_EQUAL,
+};
+
+// Quelle: https://www.youtube.com/watch?v=c065KoXooSw
+Result lineIntersection(jngl::Vec2 a, jngl::Vec2 b, jngl::Vec2 c, jngl::Vec2 d) {
+	if (boost::qvm::mag_sqr(a - c) < 0.1) {
+		return boost::qvm::mag_sqr(b - d) < 0.1 ? Result::TWO_POINTS_EQUAL
+		                                        : Result::NO_INTERSECTION;
+	}
+	if (boost::qvm::mag_sqr(a - d) < 0.1) {
+		return boost::qvm::mag_sqr(b - c) < 0.1 ? Result::TWO_POINTS_EQUAL
+		                                        : Result::NO_INTERSECTION;
+	}
+	if (boost::qvm::mag_sqr(b - d) < 0.1 || boost::qvm::mag_sqr(b - c) < 0.1) {
+		return Result::NO_INTERSECTION;
+	}
+	jngl::Vec2 const r = (b - a);
+	jngl::Vec2 const s = (d - c);
+
+	double const e = r.x * s.y - r.y * s.x;
+	double const u = ((c.x - a.x) * r.y - (c.y - a.y) * r.x) / e;
+	double const t = ((c.x - a.x) * s.y - (c.y - a.y) * s.x) / e;
+
+	// Intersection Point a + t * r
+	return (0 <= u && u <= 1 && 0 <= t && t <= 1) ? Result::INTERSECTION
+	                                              : Result::NO_INTERSECTION;
+}
+
+} // namespace
+
+VisibilityGraph::VisibilityGraph(std::function<bool(jngl::Vec2)> isWalkable)
+: isWalkable(std::move(isWalkable)) {
+}
+
+bool VisibilityGraph::setWalkableArea(std::vector<jngl::Vec2> polygon) {
+	if (polygon == walkableArea) {
+		return false;
+	}
+	walkableArea = std::move(polygon);
+	dirty = true;
+	return true;
+}
+
+bool VisibilityGraph::setObstacles(std::vector<std::vector<jngl::Vec2>> polygons) {
+	if (polygons == obstacles) {
+		return false;
+	}
+	obstacles = std::move(polygons);
+	dirty = true;
+	return true;
+}
+
+const std::vector<jngl::Vec2>& VisibilityGraph::getWalkableArea() const {
+	return walkableArea;
+}
+
+const std::vector<std::vector<jngl::Vec2>>& VisibilityGraph::getObstacles() const {
+	return obstacles;
+}
+
+void VisibilityGraph::invalidate() {
+	dirty = true;
+}
+
+const std::vector<jngl::Vec2>& VisibilityGraph::getCorners() const {
+	if (dirty) {
+		build();
+	}
+	return corners;
+}
+
+std::span<const uint32_t> VisibilityGraph::getNeighbours(const size_t index) const {
+	if (dirty) {
+		build();
+	}
+	return { edges.data() + offsets[index], edges.data() + offsets[index + 1] };
+}
+
+void VisibilityGraph::build() const {
+	dirty = false;
+	corners.clear();
+	if (!walkableArea.empty()) {
+		corners.insert(corners.end(), walkableArea.begin(), walkableArea.end() - 1);
+	}
+	for (const auto& obstacle : obstacles) {
+		if (!obstacle.empty()) {
+			corners.insert(corners.end(), obstacle.begin(), obstacle.end() - 1);
+		}
+	}
+
+	offsets.clear();
+	edges.clear();
+	offsets.reserve(corners.size() + 1);
+	offsets.push_back(0);
+	for (size_t i = 0; i < corners.size(); ++i) {
+		for (size_t j = 0; j < corners.size(); ++j) {
+			if (i != j && hasPathTo(corners[i], corners[j])) {
+				edges.push_back(static_cast<uint32_t>(j));
+			}
+		}
+		offsets.push_back(static_cast<uint32_t>(edges.size()));
+	}
+}
+
+bool VisibilityGraph::hasPathTo(jngl::Vec2 start, jngl::Vec2 target) const {
+	if (walkableArea.empty()) {
+		return false;
+	}
+	if (boost::qvm::mag_sqr(target - start) < 0.1) {
+		return false;
+	}
+
+	bool twoPointsEqual = false;
+	const auto intersectsEdgeOf = [&](const std::vector<jngl::Vec2>& polygon) {
+		for (size_t i = 0; i + 1 < polygon.size(); i++) {
+			switch (lineIntersection(start, target, polygon[i], polygon[i + 1])) {
+			case Result::INTERSECTION:
+				return true;
+			case Result::NO_INTERSECTION:
+				break;
+			case Result::TWO_POINTS_EQUAL:
+				twoPointsEqual = true;
+				break;
+			}
+		}
+		return false;
+	};
+
+	// do we intersect with an edge of the walkable area or of an obstacle?
+	if (intersectsEdgeOf(walkableArea)) {
+		return false;
+	}
+	for (const auto& obstacle : obstacles) {
+		if (intersectsEdgeOf(obstacle)) {
+			return false;
+		}
+	}
+
+	if (twoPointsEqual) {
+		return true;
+	}
+	auto direction = boost::qvm::normalized(target - start);
+	return isWalkable(start + direction); // move 1 pixel and see if that wouldn't leave the walkable area
+}
+
+std::deque<jngl::Vec2> VisibilityGraph::findPath(const jngl::Vec2 start,
+                                                 const jngl::Vec2 target) const {
+	if (boost::qvm::mag_sqr(start - target) < 1) {
+		return { start };
+	}
+	// start and target are added as the two nodes after the corners. Only they have to be tested
+	// against the cached graph.
+	const auto& corners = getCorners();
+	const auto startIndex = static_cast<uint32_t>(corners.size());
+	const auto targetIndex = startIndex + 1;
+	const auto position = [&](const uint32_t node) {
+		if (node < startIndex) {
+			return corners[node];
+		}
+		return node == startIndex ? start : target;
+	};
+	const auto distance = [](const jngl::Vec2 a, const jngl::Vec2 b) {
+		return static_cast<float>(boost::qvm::mag(a - b));
+	};
+
+	search.find(
+	    corners.size() + 2, startIndex, targetIndex,
+	    [&](const uint32_t node, const auto& visit) {
+		    const jngl::Vec2 from = position(node);
+		    if (node == startIndex) {
+			    for (uint32_t i = 0; i < startIndex; ++i) {
+				    if (hasPathTo(start, corners[i])) {
+					    visit(i, distance(start, corners[i]));
+				    }
+			    }
+		    } else {
+			    for (const auto neighbour : getNeighbours(node)) {
+				    visit(neighbour, distance(from, corners[neighbour]));
+			    }
+		    }
+		    if (hasPathTo(from, target)) {
+			    visit(targetIndex, distance(from, target));
+		    }
+	    },
+	    [&](const uint32_t node) { return distance(position(node), target); });
+
+	std::deque<jngl::Vec2> path;
+	for (const auto node : search.getPath()) {
+		path.push_back(position(node));
+	}
+	return path;
+}
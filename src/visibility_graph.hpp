@@ -0,0 +1,58 @@
+#pragma once
+
+#include "path_search.hpp"
+
+#include <jngl/Vec2.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <span>
+#include <vector>
+
+/// Which corners of the walkable area and of the non_walkable_area obstacles can see each other in
+/// a straight line. The edges are computed on first use after the geometry has changed and are then
+/// shared by all path queries.
+class VisibilityGraph {
+public:
+	/// isWalkable is probed one pixel along a line to check that it doesn't leave the walkable area
+	explicit VisibilityGraph(std::function<bool(jngl::Vec2)> isWalkable);
+
+	/// The polygons are closed, i.e. the first vertex is repeated at the end. Return false and keep
+	/// the cached edges if the geometry is the same as before.
+	bool setWalkableArea(std::vector<jngl::Vec2>);
+	bool setObstacles(std::vector<std::vector<jngl::Vec2>>);
+
+	const std::vector<jngl::Vec2>& getWalkableArea() const;
+	const std::vector<std::vector<jngl::Vec2>>& getObstacles() const;
+
+	/// Forget the cached edges, e.g. because the result of isWalkable has changed
+	void invalidate();
+
+	/// Corners of all polygons, without the repeated first vertices
+	const std::vector<jngl::Vec2>& getCorners() const;
+
+	/// Indices of the corners which can be reached from corners[index] in a straight line
+	std::span<const uint32_t> getNeighbours(size_t index) const;
+
+	bool hasPathTo(jngl::Vec2 start, jngl::Vec2 target) const;
+
+	/// Shortest path from start to target along the corners, including both. If target can't be
+	/// reached the path ends at the reachable corner closest to it.
+	std::deque<jngl::Vec2> findPath(jngl::Vec2 start, jngl::Vec2 target) const;
+
+private:
+	void build() const;
+
+	std::function<bool(jngl::Vec2)> isWalkable;
+	std::vector<jngl::Vec2> walkableArea;
+	std::vector<std::vector<jngl::Vec2>> obstacles;
+
+	mutable bool dirty = true;
+	mutable std::vector<jngl::Vec2> corners;
+	/// Neighbours of corners[i] are edges[offsets[i]] to edges[offsets[i + 1]]
+	mutable std::vector<uint32_t> offsets;
+	mutable std::vector<uint32_t> edges;
+
+	mutable PathSearch search;
+};
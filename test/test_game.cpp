@@ -23,12 +23,6 @@ namespace fs = std::filesystem;
 #endif
 #endif
 
-#ifndef NDEBUG
-void pac_unload_file(const char* path)
-{
-}
-#endif
-
 const int SEED = 0;
 const int MAX_STEPS = 10000;
 const int ACTION_TIME = 800;
@@ -99,7 +93,7 @@ suite alpaca_test_suite = []
             std::string options = "";
             for (auto &obj : game->gameObjects)
             {
-                if (game->getInactivLayerBorder() > obj->layer || obj->getParent() != nullptr)
+                if (game->getInactivLayerBorder() > obj->getLayer() || obj->getParent() != nullptr)
                 {
                     continue;
                 }
@@ -215,7 +209,7 @@ suite alpaca_test_suite = []
             std::string options;
             for (auto &obj : game->gameObjects)
             {
-                if (game->getInactivLayerBorder() > obj->layer)
+                if (game->getInactivLayerBorder() > obj->getLayer())
                 {
                     continue;
                 }
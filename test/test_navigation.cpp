@@ -0,0 +1,171 @@
+#include "ut_config.hpp"
+
+#include "../src/navmesh.hpp"
+#include "../src/visibility_graph.hpp"
+
+#include <cmath>
+#include <deque>
+#include <vector>
+
+namespace {
+
+/// Closed axis-aligned rectangle, like Background::updateCorners() creates polygons
+std::vector<jngl::Vec2> rectangle(double left, double top, double right, double bottom) {
+    return { { left, top }, { right, top }, { right, bottom }, { left, bottom }, { left, top } };
+}
+
+bool contains(const std::vector<jngl::Vec2>& polygon, const jngl::Vec2 point) {
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 2; i + 1 < polygon.size(); j = i++) {
+        const auto& a = polygon[i];
+        const auto& b = polygon[j];
+        if ((a.y > point.y) != (b.y > point.y) &&
+            point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+double length(const std::deque<jngl::Vec2>& path) {
+    double result = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        result += std::hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+    }
+    return result;
+}
+
+/// No segment of path crosses the inside of obstacle, touching its border is fine
+bool avoids(const std::deque<jngl::Vec2>& path, const std::vector<jngl::Vec2>& obstacle) {
+    for (size_t i = 1; i < path.size(); ++i) {
+        for (double t = 0.01; t < 1; t += 0.01) {
+            const jngl::Vec2 point(path[i - 1].x + (path[i].x - path[i - 1].x) * t,
+                                   path[i - 1].y + (path[i].y - path[i - 1].y) * t);
+            // Shrunk a bit, so that points on the border don't count
+            if (contains(obstacle, point) &&
+                contains(obstacle, jngl::Vec2(point.x + 0.01, point.y + 0.01)) &&
+                contains(obstacle, jngl::Vec2(point.x - 0.01, point.y - 0.01))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// A 100x100 walkable area with a 20x20 obstacle in the middle
+struct Scene {
+    Scene() : graph([this](const jngl::Vec2 position) { return isWalkable(position); }) {
+        graph.setWalkableArea(walkableArea);
+        graph.setObstacles({ obstacle });
+        built = mesh.build(walkableArea, { obstacle });
+    }
+
+    bool isWalkable(const jngl::Vec2 position) const {
+        return contains(walkableArea, position) && !contains(obstacle, position);
+    }
+
+    std::vector<jngl::Vec2> walkableArea = rectangle(0, 0, 100, 100);
+    std::vector<jngl::Vec2> obstacle = rectangle(40, 40, 60, 60);
+    VisibilityGraph graph;
+    NavMesh mesh;
+    bool built = false;
+};
+
+} // namespace
+
+using namespace boost::ut;
+suite navigation_test_suite = []
+{
+    "navmesh_polygon_with_hole"_test = []
+    {
+        const Scene scene;
+        expect(scene.built);
+        double area = 0;
+        const auto& vertices = scene.mesh.getVertices();
+        for (const auto& triangle : scene.mesh.getTriangles()) {
+            const auto& a = vertices[triangle.vertices[0]];
+            const auto& b = vertices[triangle.vertices[1]];
+            const auto& c = vertices[triangle.vertices[2]];
+            area += std::abs((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / 2;
+        }
+        expect(std::abs(area - (100 * 100 - 20 * 20)) < 0.001) << "the hole isn't cut out";
+        expect(scene.mesh.findTriangle({ 50, 50 }) == -1) << "the hole is part of the mesh";
+        expect(scene.mesh.findTriangle({ 150, 50 }) == -1);
+        expect(scene.mesh.findTriangle({ 20, 50 }) >= 0);
+
+        const auto path = scene.mesh.findPath({ 20, 50 }, { 80, 50 });
+        expect(path.size() > 2_ul) << "the path has to go around the hole";
+        expect(path.front() == jngl::Vec2(20, 50) && path.back() == jngl::Vec2(80, 50));
+        expect(avoids(path, scene.obstacle));
+    };
+
+    "navmesh_start_or_target_on_edge_or_vertex"_test = []
+    {
+        const Scene scene;
+        for (const auto& [start, target] : std::vector<std::pair<jngl::Vec2, jngl::Vec2>>{
+                 { { 40, 40 }, { 80, 80 } },   // corner of the hole
+                 { { 0, 0 }, { 100, 100 } },   // corners of the walkable area
+                 { { 50, 40 }, { 50, 60 } },   // edges of the hole
+                 { { 0, 50 }, { 100, 50 } },   // edges of the walkable area
+             }) {
+            const auto path = scene.mesh.findPath(start, target);
+            expect(path.size() >= 2_ul) << "no path from" << start.x << start.y << "to" << target.x
+                                       << target.y;
+            if (path.size() >= 2) {
+                expect(path.front() == start && path.back() == target);
+                expect(avoids(path, scene.obstacle));
+            }
+        }
+    };
+
+    "navmesh_unreachable_falls_back_to_visibility_graph"_test = []
+    {
+        // Overlapping obstacles can't be triangulated, Background::getPathToTarget() then only
+        // uses the visibility graph
+        const auto walkableArea = rectangle(0, 0, 100, 100);
+        const std::vector<std::vector<jngl::Vec2>> obstacles{ rectangle(40, 40, 60, 60),
+                                                              rectangle(55, 55, 70, 70) };
+        NavMesh mesh;
+        expect(!mesh.build(walkableArea, obstacles));
+        expect(mesh.empty());
+        expect(mesh.findPath({ 20, 50 }, { 80, 50 }).empty());
+        VisibilityGraph graph([&](const jngl::Vec2 position) {
+            return contains(walkableArea, position) && !contains(obstacles[0], position) &&
+                   !contains(obstacles[1], position);
+        });
+        graph.setWalkableArea(walkableArea);
+        graph.setObstacles(obstacles);
+        const auto fallback = graph.findPath({ 20, 50 }, { 80, 50 });
+        expect(fallback.size() > 2_ul);
+        if (!fallback.empty()) {
+            expect(fallback.front() == jngl::Vec2(20, 50) && fallback.back() == jngl::Vec2(80, 50));
+            expect(avoids(fallback, obstacles[0]) && avoids(fallback, obstacles[1]));
+        }
+
+        // A target the mesh doesn't contain: the graph ends at the closest reachable corner
+        const Scene scene;
+        expect(scene.mesh.findPath({ 20, 20 }, { 50, 50 }).empty());
+        const auto closest = scene.graph.findPath({ 20, 20 }, { 50, 50 });
+        expect(!closest.empty());
+        if (!closest.empty()) {
+            expect(closest.back() == jngl::Vec2(40, 40));
+        }
+    };
+
+    "navmesh_funnel_matches_visibility_graph"_test = []
+    {
+        const Scene scene;
+        for (const auto& [start, target] : std::vector<std::pair<jngl::Vec2, jngl::Vec2>>{
+                 { { 20, 50 }, { 80, 50 } },
+                 { { 50, 20 }, { 50, 90 } },
+                 { { 10, 30 }, { 90, 70 } },
+                 { { 10, 10 }, { 30, 90 } }, // straight line, the hole is out of the way
+             }) {
+            const auto funnel = scene.mesh.findPath(start, target);
+            const auto graph = scene.graph.findPath(start, target);
+            expect(std::abs(length(funnel) - length(graph)) < 0.001)
+                << "funnel" << length(funnel) << "graph" << length(graph);
+            expect(funnel.size() == graph.size());
+        }
+    };
+};